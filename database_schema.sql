@@ -21,13 +21,17 @@ CREATE TABLE IF NOT EXISTS customers (
 -- ============================================
 -- ACCOUNTS TABLE  
 -- Stores bank account information
+-- Money columns hold minor units (5000.00 is stored as 500000)
+-- account_type: 1 Savings, 2 Checkings, 3 Current, 4 Business
+-- status:       1 ACTIVE, 2 INACTIVE, 3 FROZEN, 4 CLOSED
+-- (codes from src/AccountCodes.h; never renumbered)
 -- ============================================
 CREATE TABLE IF NOT EXISTS accounts (
     account_number TEXT PRIMARY KEY,
     customer_id INTEGER NOT NULL,
-    account_type TEXT NOT NULL CHECK (account_type IN ('Savings', 'Checkings', 'Current', 'Business')),
-    balance REAL NOT NULL DEFAULT 0.0 CHECK (balance >= 0),
-    status TEXT DEFAULT 'ACTIVE' CHECK (status IN ('ACTIVE', 'INACTIVE', 'FROZEN', 'CLOSED')),
+    account_type INTEGER NOT NULL CHECK (account_type BETWEEN 1 AND 4),
+    balance INTEGER NOT NULL DEFAULT 0 CHECK (balance >= 0),
+    status INTEGER NOT NULL DEFAULT 1 CHECK (status BETWEEN 1 AND 4),
     created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
     FOREIGN KEY (customer_id) REFERENCES customers (customer_id) ON DELETE CASCADE
 );
@@ -35,19 +39,76 @@ CREATE TABLE IF NOT EXISTS accounts (
 -- ============================================
 -- TRANSACTIONS TABLE
 -- Stores all banking transactions
+-- transaction_type: 1 DEPOSIT, 2 WITHDRAWAL, 3 TRANSFER_IN, 4 TRANSFER_OUT, 5 INTEREST, 6 FEE
 -- ============================================
 CREATE TABLE IF NOT EXISTS transactions (
     transaction_id INTEGER PRIMARY KEY AUTOINCREMENT,
     account_number TEXT NOT NULL,
-    transaction_type TEXT NOT NULL CHECK (transaction_type IN ('DEPOSIT', 'WITHDRAWAL', 'TRANSFER_IN', 'TRANSFER_OUT', 'INTEREST', 'FEE')),
-    amount REAL NOT NULL CHECK (amount > 0),
-    balance_after REAL NOT NULL CHECK (balance_after >= 0),
+    transaction_type INTEGER NOT NULL CHECK (transaction_type BETWEEN 1 AND 6),
+    amount INTEGER NOT NULL CHECK (amount > 0),
+    balance_after INTEGER NOT NULL CHECK (balance_after >= 0),
     description TEXT,
     transaction_date DATETIME DEFAULT CURRENT_TIMESTAMP,
-    reference_number TEXT,
+    reference_number INTEGER,  -- journal id shared by the TRANSFER_OUT and TRANSFER_IN legs
     FOREIGN KEY (account_number) REFERENCES accounts (account_number) ON DELETE CASCADE
 );
 
+-- ============================================
+-- DAILY WITHDRAWALS TABLE
+-- Running withdrawal total per account per UTC day (YYYY-MM-DD)
+-- ============================================
+CREATE TABLE IF NOT EXISTS daily_withdrawals (
+    account_number TEXT NOT NULL,
+    day TEXT NOT NULL,
+    total INTEGER NOT NULL,
+    PRIMARY KEY (account_number, day)
+) WITHOUT ROWID;
+
+-- ============================================
+-- INTEREST RUNS TABLE
+-- One row per month-end interest period (YYYY-MM); last_account is the
+-- checkpoint an interrupted run resumes after
+-- ============================================
+CREATE TABLE IF NOT EXISTS interest_runs (
+    period TEXT PRIMARY KEY,
+    rate_basis_points INTEGER NOT NULL,
+    days INTEGER NOT NULL,
+    last_account TEXT NOT NULL DEFAULT '',
+    accounts_credited INTEGER NOT NULL DEFAULT 0,
+    total_interest INTEGER NOT NULL DEFAULT 0,
+    completed INTEGER NOT NULL DEFAULT 0,
+    updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+);
+
+-- ============================================
+-- FEE RULES TABLE
+-- Month-end fees by account type. condition: 1 ALWAYS, 2 BALANCE_BELOW
+-- (threshold in minor units), 3 WITHDRAWALS_ABOVE (amount per withdrawal
+-- past threshold), 4 NO_ACTIVITY. amount is in minor units.
+-- ============================================
+CREATE TABLE IF NOT EXISTS fee_rules (
+    rule_id INTEGER PRIMARY KEY,
+    account_type INTEGER NOT NULL CHECK (account_type BETWEEN 1 AND 4),
+    name TEXT NOT NULL,
+    condition INTEGER NOT NULL CHECK (condition BETWEEN 1 AND 4),
+    threshold INTEGER NOT NULL DEFAULT 0 CHECK (threshold >= 0),
+    amount INTEGER NOT NULL CHECK (amount > 0)
+);
+
+-- ============================================
+-- FEE RUNS TABLE
+-- One row per fee period (YYYY-MM), checkpointed like interest_runs
+-- ============================================
+CREATE TABLE IF NOT EXISTS fee_runs (
+    period TEXT PRIMARY KEY,
+    last_account TEXT NOT NULL DEFAULT '',
+    fees_charged INTEGER NOT NULL DEFAULT 0,
+    total_fees INTEGER NOT NULL DEFAULT 0,
+    fees_uncollected INTEGER NOT NULL DEFAULT 0,
+    completed INTEGER NOT NULL DEFAULT 0,
+    updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+);
+
 -- ============================================
 -- INDEXES FOR PERFORMANCE
 -- ============================================
@@ -57,6 +118,8 @@ CREATE INDEX IF NOT EXISTS idx_accounts_status ON accounts(status);
 CREATE INDEX IF NOT EXISTS idx_transactions_account_number ON transactions(account_number);
 CREATE INDEX IF NOT EXISTS idx_transactions_date ON transactions(transaction_date);
 CREATE INDEX IF NOT EXISTS idx_transactions_type ON transactions(transaction_type);
+CREATE INDEX IF NOT EXISTS idx_transactions_account_date ON transactions(account_number, transaction_date DESC, transaction_id DESC);
+CREATE INDEX IF NOT EXISTS idx_transactions_reference ON transactions(reference_number) WHERE reference_number IS NOT NULL;
 
 -- ============================================
 -- SAMPLE TEST DATA
@@ -72,42 +135,49 @@ INSERT OR IGNORE INTO customers (first_name, middle_name, last_name, email, phon
 
 -- Insert sample accounts
 INSERT OR IGNORE INTO accounts (account_number, customer_id, account_type, balance, status) VALUES
-('100000001', 1, 'Savings', 5000.00, 'ACTIVE'),
-('100000002', 1, 'Checkings', 2500.00, 'ACTIVE'),
-('100000003', 2, 'Savings', 3200.00, 'ACTIVE'),
-('100000004', 3, 'Checkings', 1800.00, 'ACTIVE'),
-('100000005', 3, 'Savings', 7500.00, 'ACTIVE'),
-('100000006', 4, 'Savings', 4200.00, 'ACTIVE'),
-('100000007', 5, 'Checkings', 950.00, 'ACTIVE');
+('100000001', 1, 1, 500000, 1),
+('100000002', 1, 2, 250000, 1),
+('100000003', 2, 1, 320000, 1),
+('100000004', 3, 2, 180000, 1),
+('100000005', 3, 1, 750000, 1),
+('100000006', 4, 1, 420000, 1),
+('100000007', 5, 2, 95000, 1);
+
+-- Default fee rules
+INSERT OR IGNORE INTO fee_rules (rule_id, account_type, name, condition, threshold, amount) VALUES
+(1, 1, 'Minimum balance fee', 2, 10000, 500),
+(2, 1, 'Excess withdrawal fee', 3, 4, 200),
+(3, 2, 'Monthly maintenance fee', 2, 100000, 1000),
+(4, 2, 'Dormant account fee', 4, 0, 300);
 
 -- Insert sample transactions
 INSERT OR IGNORE INTO transactions (account_number, transaction_type, amount, balance_after, description) VALUES
-('100000001', 'DEPOSIT', 5000.00, 5000.00, 'Initial deposit'),
-('100000001', 'WITHDRAWAL', 500.00, 4500.00, 'ATM withdrawal'),
-('100000001', 'DEPOSIT', 1200.00, 5700.00, 'Salary deposit'),
-('100000001', 'WITHDRAWAL', 700.00, 5000.00, 'Cash withdrawal'),
+('100000001', 1, 500000, 500000, 'Initial deposit'),
+('100000001', 2, 50000, 450000, 'ATM withdrawal'),
+('100000001', 1, 120000, 570000, 'Salary deposit'),
+('100000001', 2, 70000, 500000, 'Cash withdrawal'),
 
-('100000002', 'DEPOSIT', 2500.00, 2500.00, 'Initial deposit'),
-('100000002', 'WITHDRAWAL', 150.00, 2350.00, 'ATM withdrawal'),
-('100000002', 'WITHDRAWAL', 200.00, 2150.00, 'Cash withdrawal'),
-('100000002', 'DEPOSIT', 350.00, 2500.00, 'Cash deposit'),
+('100000002', 1, 250000, 250000, 'Initial deposit'),
+('100000002', 2, 15000, 235000, 'ATM withdrawal'),
+('100000002', 2, 20000, 215000, 'Cash withdrawal'),
+('100000002', 1, 35000, 250000, 'Cash deposit'),
 
-('100000003', 'DEPOSIT', 3200.00, 3200.00, 'Initial deposit'),
-('100000003', 'DEPOSIT', 800.00, 4000.00, 'Monthly savings'),
-('100000003', 'WITHDRAWAL', 800.00, 3200.00, 'Emergency withdrawal'),
+('100000003', 1, 320000, 320000, 'Initial deposit'),
+('100000003', 1, 80000, 400000, 'Monthly savings'),
+('100000003', 2, 80000, 320000, 'Emergency withdrawal'),
 
-('100000004', 'DEPOSIT', 1800.00, 1800.00, 'Initial deposit'),
-('100000004', 'WITHDRAWAL', 300.00, 1500.00, 'Bill payment'),
-('100000004', 'DEPOSIT', 500.00, 2000.00, 'Freelance payment'),
-('100000004', 'WITHDRAWAL', 200.00, 1800.00, 'Shopping'),
+('100000004', 1, 180000, 180000, 'Initial deposit'),
+('100000004', 2, 30000, 150000, 'Bill payment'),
+('100000004', 1, 50000, 200000, 'Freelance payment'),
+('100000004', 2, 20000, 180000, 'Shopping'),
 
-('100000005', 'DEPOSIT', 7500.00, 7500.00, 'Initial deposit'),
+('100000005', 1, 750000, 750000, 'Initial deposit'),
 
-('100000006', 'DEPOSIT', 4200.00, 4200.00, 'Initial deposit'),
-('100000006', 'WITHDRAWAL', 400.00, 3800.00, 'School fees'),
-('100000006', 'DEPOSIT', 400.00, 4200.00, 'Scholarship refund'),
+('100000006', 1, 420000, 420000, 'Initial deposit'),
+('100000006', 2, 40000, 380000, 'School fees'),
+('100000006', 1, 40000, 420000, 'Scholarship refund'),
 
-('100000007', 'DEPOSIT', 950.00, 950.00, 'Initial deposit');
+('100000007', 1, 95000, 95000, 'Initial deposit');
 
 -- ============================================
 -- USEFUL QUERIES FOR TESTING
@@ -121,7 +191,7 @@ INSERT OR IGNORE INTO transactions (account_number, transaction_type, amount, ba
 --     a.account_number,
 --     c.first_name || ' ' || c.last_name as customer_name,
 --     a.account_type,
---     a.balance,
+--     printf('%.2f', a.balance / 100.0) as balance,
 --     a.status
 -- FROM accounts a
 -- JOIN customers c ON a.customer_id = c.customer_id;
@@ -129,20 +199,20 @@ INSERT OR IGNORE INTO transactions (account_number, transaction_type, amount, ba
 -- View transaction history for an account
 -- SELECT 
 --     transaction_type,
---     amount,
---     balance_after,
+--     printf('%.2f', amount / 100.0) as amount,
+--     printf('%.2f', balance_after / 100.0) as balance_after,
 --     description,
 --     transaction_date
 -- FROM transactions 
 -- WHERE account_number = '100000001'
--- ORDER BY transaction_date DESC;
+-- ORDER BY transaction_date DESC, transaction_id DESC;
 
 -- Customer account summary
 -- SELECT 
 --     c.first_name || ' ' || c.last_name as customer_name,
 --     COUNT(a.account_number) as total_accounts,
---     SUM(a.balance) as total_balance
+--     printf('%.2f', SUM(a.balance) / 100.0) as total_balance
 -- FROM customers c
 -- LEFT JOIN accounts a ON c.customer_id = a.customer_id
--- WHERE a.status = 'ACTIVE'
+-- WHERE a.status = 1
 -- GROUP BY c.customer_id;
\ No newline at end of file
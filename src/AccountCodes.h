@@ -0,0 +1,121 @@
+#ifndef ACCOUNT_CODES_H
+#define ACCOUNT_CODES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// One-byte codes for account types, account statuses, ledger entry types and
+// fee conditions. The tables store these same values, so a code must never be
+// renumbered; new ones go at the end. 0 is never stored and stands for
+// anything unrecognised. Names are only for input and display.
+enum class AccountType : uint8_t {
+    Unknown,
+    Savings,
+    Checkings,
+    Current,
+    Business
+};
+
+enum class AccountStatus : uint8_t {
+    Unknown,
+    Active,
+    Inactive,
+    Frozen,
+    Closed
+};
+
+enum class TransactionType : uint8_t {
+    Unknown,
+    Deposit,
+    Withdrawal,
+    TransferIn,
+    TransferOut,
+    Interest,
+    Fee
+};
+
+// When a fee_rules row charges, tested against the month being assessed
+enum class FeeCondition : uint8_t {
+    Unknown,
+    Always,             // every active account of the type
+    BalanceBelow,       // balance under threshold (minor units)
+    WithdrawalsAbove,   // amount per withdrawal past the first threshold
+    NoActivity          // no customer transactions in the month
+};
+
+namespace AccountCodes {
+    // Indexed by code. Also the TEXT values schema version 2 stored.
+    inline constexpr const char* ACCOUNT_TYPE_NAMES[] = {"", "Savings", "Checkings", "Current", "Business"};
+    inline constexpr const char* ACCOUNT_STATUS_NAMES[] = {"", "ACTIVE", "INACTIVE", "FROZEN", "CLOSED"};
+    inline constexpr const char* TRANSACTION_TYPE_NAMES[] = {
+        "", "DEPOSIT", "WITHDRAWAL", "TRANSFER_IN", "TRANSFER_OUT", "INTEREST", "FEE"
+    };
+    inline constexpr const char* FEE_CONDITION_NAMES[] = {
+        "", "ALWAYS", "BALANCE_BELOW", "WITHDRAWALS_ABOVE", "NO_ACTIVITY"
+    };
+
+    template <size_t N>
+    constexpr const char* nameOf(const char* const (&names)[N], int code) {
+        return code > 0 && code < static_cast<int>(N) ? names[code] : "";
+    }
+
+    template <size_t N>
+    int codeOf(const char* const (&names)[N], const std::string& name) {
+        for (size_t code = 1; code < N; ++code) {
+            if (name == names[code]) {
+                return static_cast<int>(code);
+            }
+        }
+        return 0;
+    }
+
+    // "" for Unknown
+    constexpr const char* name(AccountType type) { return nameOf(ACCOUNT_TYPE_NAMES, static_cast<int>(type)); }
+    constexpr const char* name(AccountStatus status) { return nameOf(ACCOUNT_STATUS_NAMES, static_cast<int>(status)); }
+    constexpr const char* name(TransactionType type) { return nameOf(TRANSACTION_TYPE_NAMES, static_cast<int>(type)); }
+    constexpr const char* name(FeeCondition condition) { return nameOf(FEE_CONDITION_NAMES, static_cast<int>(condition)); }
+
+    // +1 for credits, -1 for debits, 0 for anything the ledger does not accept
+    constexpr int direction(TransactionType type) {
+        switch (type) {
+            case TransactionType::Deposit:
+            case TransactionType::TransferIn:
+            case TransactionType::Interest:
+                return 1;
+            case TransactionType::Withdrawal:
+            case TransactionType::TransferOut:
+            case TransactionType::Fee:
+                return -1;
+            default:
+                return 0;
+        }
+    }
+
+    // Exact, case-sensitive match on the names above; Unknown otherwise
+    inline AccountType parseAccountType(const std::string& name) {
+        return static_cast<AccountType>(codeOf(ACCOUNT_TYPE_NAMES, name));
+    }
+    inline AccountStatus parseAccountStatus(const std::string& name) {
+        return static_cast<AccountStatus>(codeOf(ACCOUNT_STATUS_NAMES, name));
+    }
+    inline TransactionType parseTransactionType(const std::string& name) {
+        return static_cast<TransactionType>(codeOf(TRANSACTION_TYPE_NAMES, name));
+    }
+
+    // Column values read back from SQLite; anything out of range is Unknown
+    constexpr AccountType toAccountType(int code) {
+        return *nameOf(ACCOUNT_TYPE_NAMES, code) ? static_cast<AccountType>(code) : AccountType::Unknown;
+    }
+    constexpr AccountStatus toAccountStatus(int code) {
+        return *nameOf(ACCOUNT_STATUS_NAMES, code) ? static_cast<AccountStatus>(code) : AccountStatus::Unknown;
+    }
+    constexpr TransactionType toTransactionType(int code) {
+        return *nameOf(TRANSACTION_TYPE_NAMES, code) ? static_cast<TransactionType>(code) : TransactionType::Unknown;
+    }
+    constexpr FeeCondition toFeeCondition(int code) {
+        return *nameOf(FEE_CONDITION_NAMES, code) ? static_cast<FeeCondition>(code) : FeeCondition::Unknown;
+    }
+}
+
+#endif
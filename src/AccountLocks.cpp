@@ -0,0 +1,121 @@
+#include "AccountLocks.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+AccountLockManager::AccountLockManager(size_t stripeCount) {
+    size_t count = 1;
+    while (count < stripeCount) {
+        count <<= 1;
+    }
+    stripes.reset(new Stripe[count]);
+    stripeMask = count - 1;
+}
+
+size_t AccountLockManager::stripeIndex(const std::string& accountNumber) const {
+    return std::hash<std::string>()(accountNumber) & stripeMask;
+}
+
+void AccountLockManager::acquire(size_t index, const std::string& accountNumber) {
+    Stripe& stripe = stripes[index];
+    if (stripe.mutex.try_lock()) {
+        ++stripe.acquisitions;
+        return;
+    }
+
+    auto before = std::chrono::steady_clock::now();
+    stripe.mutex.lock();
+    auto waited = std::chrono::steady_clock::now() - before;
+
+    ++stripe.acquisitions;
+    ++stripe.contended;
+    stripe.waitNs += std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count();
+    
+    HotSlot* coldest = &stripe.hotSlots[0];
+    for (HotSlot& slot : stripe.hotSlots) {
+        if (slot.accountNumber == accountNumber) {
+            ++slot.contended;
+            return;
+        }
+        if (slot.contended < coldest->contended) {
+            coldest = &slot;
+        }
+    }
+    coldest->accountNumber = accountNumber;
+    ++coldest->contended;
+}
+
+AccountLockManager::Guard AccountLockManager::lock(const std::string& accountNumber) {
+    size_t index = stripeIndex(accountNumber);
+    acquire(index, accountNumber);
+    return Guard(this, index, index);
+}
+
+AccountLockManager::Guard AccountLockManager::lock(const std::string& firstAccount,
+                                                   const std::string& secondAccount) {
+    size_t firstIndex = stripeIndex(firstAccount);
+    size_t secondIndex = stripeIndex(secondAccount);
+    if (firstIndex == secondIndex) {
+        acquire(firstIndex, firstAccount);
+        return Guard(this, firstIndex, firstIndex);
+    }
+
+    // Canonical order: lower stripe first
+    if (secondIndex < firstIndex) {
+        acquire(secondIndex, secondAccount);
+        acquire(firstIndex, firstAccount);
+    } else {
+        acquire(firstIndex, firstAccount);
+        acquire(secondIndex, secondAccount);
+    }
+    return Guard(this, firstIndex, secondIndex);
+}
+
+AccountLockManager::Stats AccountLockManager::getStats() const {
+    Stats stats = {stripeMask + 1, 0, 0, 0};
+    for (size_t i = 0; i <= stripeMask; ++i) {
+        Stripe& stripe = stripes[i];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stats.acquisitions += stripe.acquisitions;
+        stats.contended += stripe.contended;
+        stats.waitNs += stripe.waitNs;
+    }
+    return stats;
+}
+
+std::vector<AccountLockManager::HotAccount> AccountLockManager::getHotAccounts(size_t limit) const {
+    std::vector<HotAccount> hot;
+    for (size_t i = 0; i <= stripeMask; ++i) {
+        Stripe& stripe = stripes[i];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        for (const HotSlot& slot : stripe.hotSlots) {
+            if (slot.contended > 0) {
+                hot.push_back({slot.accountNumber, slot.contended});
+            }
+        }
+    }
+
+    size_t count = std::min(limit, hot.size());
+    std::partial_sort(hot.begin(), hot.begin() + count, hot.end(),
+                      [](const HotAccount& a, const HotAccount& b) { return a.contended > b.contended; });
+    hot.resize(count);
+    return hot;
+}
+
+AccountLockManager::Guard::Guard(AccountLockManager* manager, size_t first, size_t second)
+    : manager(manager), first(first), second(second) {}
+
+AccountLockManager::Guard::Guard(Guard&& other) noexcept
+    : manager(other.manager), first(other.first), second(other.second) {
+    other.manager = nullptr;
+}
+
+AccountLockManager::Guard::~Guard() {
+    if (!manager) {
+        return;
+    }
+    if (second != first) {
+        manager->stripes[second].mutex.unlock();
+    }
+    manager->stripes[first].mutex.unlock();
+}
@@ -0,0 +1,90 @@
+#ifndef ACCOUNT_LOCKS_H
+#define ACCOUNT_LOCKS_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// In-process per-account locks. Account numbers hash onto a fixed set of
+// striped mutexes, so work on one account is serialized while different
+// accounts almost always proceed in parallel. Two-account operations take
+// their stripes in ascending stripe order, which rules out lock-order
+// deadlocks however the accounts are passed in.
+//
+// Every acquisition first tries the stripe without blocking. A failed try
+// counts as contention, and the account that waited is remembered so hot
+// accounts show up in getHotAccounts(). Each stripe remembers at most
+// HOT_SLOTS accounts (space-saving top-K): a new account takes the slot of the
+// least contended one and inherits its count, so memory stays fixed however
+// long the server runs, and a truly hot account is never pushed out.
+class AccountLockManager {
+private:
+    static const size_t HOT_SLOTS = 4;
+    
+    struct HotSlot {
+        std::string accountNumber;
+        unsigned long long contended = 0;
+    };
+    
+    // One cache line per stripe so neighbouring stripes never false-share
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        // Guarded by mutex
+        unsigned long long acquisitions = 0;
+        unsigned long long contended = 0;
+        unsigned long long waitNs = 0;
+        std::array<HotSlot, HOT_SLOTS> hotSlots;
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    size_t stripeMask;
+
+    size_t stripeIndex(const std::string& accountNumber) const;
+    void acquire(size_t index, const std::string& accountNumber);
+
+public:
+    // Holds one or two stripes until destroyed
+    class Guard {
+    private:
+        AccountLockManager* manager;
+        size_t first;
+        size_t second;          // == first when only one stripe is held
+    public:
+        Guard(AccountLockManager* manager, size_t first, size_t second);
+        Guard(Guard&& other) noexcept;
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+    };
+
+    struct Stats {
+        size_t stripes;
+        unsigned long long acquisitions;
+        unsigned long long contended;
+        unsigned long long waitNs;
+    };
+
+    struct HotAccount {
+        std::string accountNumber;
+        unsigned long long contended;   // may overcount by what the slot's previous account had
+    };
+
+    // Rounded up to a power of two
+    explicit AccountLockManager(size_t stripeCount = 1024);
+
+    AccountLockManager(const AccountLockManager&) = delete;
+    AccountLockManager& operator=(const AccountLockManager&) = delete;
+
+    Guard lock(const std::string& accountNumber);
+    Guard lock(const std::string& firstAccount, const std::string& secondAccount);
+
+    // Both briefly take every stripe, so never call them while holding a Guard
+    Stats getStats() const;
+    std::vector<HotAccount> getHotAccounts(size_t limit) const;    // most contended first
+};
+
+#endif
@@ -4,15 +4,22 @@
 #include <sstream>
 #include <algorithm>
 
-const double BankAccount::MINIMUM_BALANCE = 0.0;
-const double BankAccount::MAXIMUM_BALANCE = 1000000.0;
+namespace {
+    // Indexed by AccountType code
+    constexpr const char* ACCOUNT_TYPE_DISPLAY[] = {"", " Savings Account", "💳 Checkings Account", "Current", "Business"};
+}
+
+const Money BankAccount::MINIMUM_BALANCE = Money();
+const Money BankAccount::MAXIMUM_BALANCE = Money::fromMajorUnits(1000000);
 
-BankAccount::BankAccount() : balance(0.0), customerId(-1), status("INACTIVE") {}
+BankAccount::BankAccount()
+    : accountType(AccountType::Unknown), balance(), customerId(-1), status(AccountStatus::Inactive),
+      localHistoryStart(0), localHistoryCount(0) {}
 
 BankAccount::BankAccount(const std::string& accountNumber, int customerId, 
-                        const std::string& accountType, double initialBalance)
+                        AccountType accountType, Money initialBalance)
     : accountNumber(accountNumber), customerId(customerId), accountType(accountType), 
-      balance(initialBalance), status("ACTIVE") {}
+      balance(initialBalance), status(AccountStatus::Active), localHistoryStart(0), localHistoryCount(0) {}
 
 BankAccount::~BankAccount() {}
 
@@ -24,27 +31,27 @@ std::string BankAccount::getAccountNumber() const {
     return accountNumber;
 }
 
-void BankAccount::setBalance(double bal) {
+void BankAccount::setBalance(Money bal) {
     if (bal >= MINIMUM_BALANCE && bal <= MAXIMUM_BALANCE) {
         balance = bal;
     }
 }
 
-double BankAccount::getBalance() const {
+Money BankAccount::getBalance() const {
     return balance;
 }
 
-bool BankAccount::hasSufficientFunds(double amount) const {
-    return balance >= amount && amount > 0;
+bool BankAccount::hasSufficientFunds(Money amount) const {
+    return balance >= amount && amount.isPositive();
 }
 
-void BankAccount::setAccountType(const std::string& type) {
+void BankAccount::setAccountType(AccountType type) {
     if (isValidAccountType(type)) {
         accountType = type;
     }
 }
 
-std::string BankAccount::getAccountType() const {
+AccountType BankAccount::getAccountType() const {
     return accountType;
 }
 
@@ -56,76 +63,77 @@ int BankAccount::getCustomerId() const {
     return customerId;
 }
 
-void BankAccount::setStatus(const std::string& accountStatus) {
-    if (accountStatus == "ACTIVE" || accountStatus == "INACTIVE" || 
-        accountStatus == "FROZEN" || accountStatus == "CLOSED") {
+void BankAccount::setStatus(AccountStatus accountStatus) {
+    if (*AccountCodes::name(accountStatus)) {
         status = accountStatus;
     }
 }
 
-std::string BankAccount::getStatus() const {
+AccountStatus BankAccount::getStatus() const {
     return status;
 }
 
 bool BankAccount::isActive() const {
-    return status == "ACTIVE";
+    return status == AccountStatus::Active;
 }
 
-bool BankAccount::canWithdraw(double amount) const {
-    return isActive() && hasSufficientFunds(amount) && amount > 0;
+bool BankAccount::canWithdraw(Money amount) const {
+    return isActive() && hasSufficientFunds(amount) && amount.isPositive();
 }
 
-bool BankAccount::processWithdrawal(double amount) {
+bool BankAccount::processWithdrawal(Money amount) {
     if (!canWithdraw(amount)) {
         return false;
     }
     
     balance -= amount;
-    
-    // Add to local transaction history
-    std::stringstream ss;
-    ss << "WITHDRAWAL|" << std::fixed << std::setprecision(2) << amount 
-       << "|" << balance << "|Cash withdrawal|" << "Local Transaction";
-    addTransactionToHistory(ss.str());
+    addTransactionToHistory({LocalTransaction::Kind::Withdrawal, amount, balance});
     
     return true;
 }
 
-bool BankAccount::processDeposit(double amount) {
-    if (!isActive() || amount <= 0 || (balance + amount) > MAXIMUM_BALANCE) {
+bool BankAccount::processDeposit(Money amount) {
+    if (!isActive() || !amount.isPositive() || (balance + amount) > MAXIMUM_BALANCE) {
         return false;
     }
     
     balance += amount;
-    
-    // Add to local transaction history
-    std::stringstream ss;
-    ss << "DEPOSIT|" << std::fixed << std::setprecision(2) << amount 
-       << "|" << balance << "|Cash deposit|" << "Local Transaction";
-    addTransactionToHistory(ss.str());
+    addTransactionToHistory({LocalTransaction::Kind::Deposit, amount, balance});
     
     return true;
 }
 
-void BankAccount::addTransactionToHistory(const std::string& transactionRecord) {
-    localTransactionHistory.push_back(transactionRecord);
-    
-    // Keep only last 20 transactions in local cache
-    if (localTransactionHistory.size() > 20) {
-        localTransactionHistory.erase(localTransactionHistory.begin());
+void BankAccount::addTransactionToHistory(const LocalTransaction& record) {
+    if (localHistoryCount < LOCAL_HISTORY_CAPACITY) {
+        localTransactionHistory[(localHistoryStart + localHistoryCount) % LOCAL_HISTORY_CAPACITY] = record;
+        ++localHistoryCount;
+        return;
     }
+    
+    // Full: overwrite the oldest entry, which makes the next one the oldest
+    localTransactionHistory[localHistoryStart] = record;
+    localHistoryStart = (localHistoryStart + 1) % LOCAL_HISTORY_CAPACITY;
 }
 
 void BankAccount::clearTransactionHistory() {
-    localTransactionHistory.clear();
+    localHistoryStart = 0;
+    localHistoryCount = 0;
 }
 
-std::vector<std::string> BankAccount::getLocalTransactionHistory() const {
-    return localTransactionHistory;
+BankAccount::LocalHistoryView BankAccount::getLocalTransactionHistory() const {
+    return LocalHistoryView(localTransactionHistory.data(), localHistoryStart, localHistoryCount);
 }
 
 bool BankAccount::hasTransactionHistory() const {
-    return !localTransactionHistory.empty();
+    return localHistoryCount > 0;
+}
+
+std::string BankAccount::formatLocalTransaction(const LocalTransaction& record) {
+    bool deposit = record.kind == LocalTransaction::Kind::Deposit;
+    std::stringstream ss;
+    ss << (deposit ? "DEPOSIT|" : "WITHDRAWAL|") << record.amount << "|" << record.balanceAfter
+       << (deposit ? "|Cash deposit|" : "|Cash withdrawal|") << "Local Transaction";
+    return ss.str();
 }
 
 bool BankAccount::isValidAccount() const {
@@ -134,8 +142,7 @@ bool BankAccount::isValidAccount() const {
 
 std::string BankAccount::getAccountSummary() const {
     std::stringstream ss;
-    ss << accountNumber << " (" << getAccountTypeDisplay() << ") - $" 
-       << std::fixed << std::setprecision(2) << balance;
+    ss << accountNumber << " (" << getAccountTypeDisplay() << ") - $" << balance;
     return ss.str();
 }
 
@@ -145,25 +152,20 @@ void BankAccount::displayAccountDetails() const {
     std::cout << "Account Number: " << accountNumber << std::endl;
     std::cout << "Account Type: " << getAccountTypeDisplay() << std::endl;
     std::cout << "Current Balance: " << formatBalance() << std::endl;
-    std::cout << "Status: " << status << std::endl;
+    std::cout << "Status: " << AccountCodes::name(status) << std::endl;
     std::cout << "Customer ID: " << customerId << std::endl;
 }
 
 std::string BankAccount::formatBalance() const {
     std::stringstream ss;
-    ss << "$" << std::fixed << std::setprecision(2) << balance;
+    ss << "$" << balance;
     return ss.str();
 }
 
 std::string BankAccount::getAccountTypeDisplay() const {
-    if (accountType == "Savings") {
-        return " Savings Account";
-    } else if (accountType == "Checkings") {
-        return "💳 Checkings Account";
-    }
-    return accountType;
+    return AccountCodes::nameOf(ACCOUNT_TYPE_DISPLAY, static_cast<int>(accountType));
 }
 
-bool BankAccount::isValidAccountType(const std::string& type) {
-    return type == "Savings" || type == "Checkings" || type == "Current" || type == "Business";
+bool BankAccount::isValidAccountType(AccountType type) {
+    return *AccountCodes::name(type) != '\0';    // Unknown and out-of-range codes have no name
 }
\ No newline at end of file
@@ -1,22 +1,62 @@
 #ifndef BANK_ACCOUNT_H
 #define BANK_ACCOUNT_H
 
+#include "AccountCodes.h"
+#include "Money.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <string>
-#include <vector>
 
 class BankAccount {
+public:
+    // One local history entry; the text form is only built for display
+    struct LocalTransaction {
+        enum class Kind : uint8_t {
+            Deposit,
+            Withdrawal
+        };
+        
+        Kind kind;
+        Money amount;
+        Money balanceAfter;
+    };
+    
+    static const size_t LOCAL_HISTORY_CAPACITY = 20;
+    
+    // Read-only window onto the local history, oldest entry first. Valid until
+    // the account records or clears a transaction.
+    class LocalHistoryView {
+    private:
+        const LocalTransaction* records;
+        size_t start;
+        size_t count;
+    public:
+        LocalHistoryView(const LocalTransaction* records, size_t start, size_t count)
+            : records(records), start(start), count(count) {}
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const LocalTransaction& operator[](size_t index) const {
+            return records[(start + index) % LOCAL_HISTORY_CAPACITY];
+        }
+    };
+    
 private:
     std::string accountNumber;
-    std::string accountType;
-    double balance;
-    std::string status;
+    AccountType accountType;
+    Money balance;
+    AccountStatus status;
     int customerId;
-    std::vector<std::string> localTransactionHistory; // For temporary storage
+    
+    // Ring buffer of the most recent local transactions; the oldest is overwritten when full
+    std::array<LocalTransaction, LOCAL_HISTORY_CAPACITY> localTransactionHistory;
+    size_t localHistoryStart;
+    size_t localHistoryCount;
     
 public:
     BankAccount();
-    BankAccount(const std::string& accountNumber, int customerId, const std::string& accountType, double initialBalance = 0.0);
+    BankAccount(const std::string& accountNumber, int customerId, AccountType accountType, Money initialBalance = Money());
     ~BankAccount();
     
     // Account number management
@@ -24,33 +64,34 @@ public:
     std::string getAccountNumber() const;
     
     // Balance management
-    void setBalance(double bal);
-    double getBalance() const;
-    bool hasSufficientFunds(double amount) const;
+    void setBalance(Money bal);
+    Money getBalance() const;
+    bool hasSufficientFunds(Money amount) const;
     
     // Account type management
-    void setAccountType(const std::string& type);
-    std::string getAccountType() const;
+    void setAccountType(AccountType type);
+    AccountType getAccountType() const;
     
     // Customer ID management
     void setCustomerId(int id);
     int getCustomerId() const;
     
     // Account status management
-    void setStatus(const std::string& accountStatus);
-    std::string getStatus() const;
+    void setStatus(AccountStatus accountStatus);
+    AccountStatus getStatus() const;
     bool isActive() const;
     
     // Transaction operations (for local operations before database sync)
-    bool canWithdraw(double amount) const;
-    bool processWithdrawal(double amount);
-    bool processDeposit(double amount);
+    bool canWithdraw(Money amount) const;
+    bool processWithdrawal(Money amount);
+    bool processDeposit(Money amount);
     
     // Transaction history (local cache)
-    void addTransactionToHistory(const std::string& transactionRecord);
+    void addTransactionToHistory(const LocalTransaction& record);
     void clearTransactionHistory();
-    std::vector<std::string> getLocalTransactionHistory() const;
+    LocalHistoryView getLocalTransactionHistory() const;
     bool hasTransactionHistory() const;
+    static std::string formatLocalTransaction(const LocalTransaction& record);   // "DEPOSIT|amount|balance|..." 
     
     // Account validation
     bool isValidAccount() const;
@@ -64,9 +105,9 @@ public:
     std::string getAccountTypeDisplay() const;
     
     // Account limits and rules
-    static const double MINIMUM_BALANCE;
-    static const double MAXIMUM_BALANCE;
-    static bool isValidAccountType(const std::string& type);
+    static const Money MINIMUM_BALANCE;
+    static const Money MAXIMUM_BALANCE;
+    static bool isValidAccountType(AccountType type);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,541 @@
+#include "BankingServer.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    const size_t MAX_REQUEST_LINE = 4096;
+    const int MAX_EVENTS = 256;
+    const int HISTORY_PAGE_SIZE = 10;
+
+    // Request bytes can have the high bit set, which <cctype> must never see as a negative char
+    char toUpper(char c) {
+        return static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    bool isDigit(char c) {
+        return std::isdigit(static_cast<unsigned char>(c)) != 0;
+    }
+
+    const char* resultCode(Database::TransactionResult result) {
+        switch (result) {
+            case Database::TransactionResult::InvalidType:       return "ERR BAD_REQUEST invalid transaction type";
+            case Database::TransactionResult::InvalidAmount:     return "ERR INVALID_AMOUNT amount outside allowed limits";
+            case Database::TransactionResult::AccountNotFound:   return "ERR NO_ACCOUNT no active account selected";
+            case Database::TransactionResult::AccountInactive:   return "ERR ACCOUNT_INACTIVE account is not active";
+            case Database::TransactionResult::InsufficientFunds: return "ERR INSUFFICIENT_FUNDS";
+            case Database::TransactionResult::SameAccount:       return "ERR SAME_ACCOUNT cannot transfer to the same account";
+            case Database::TransactionResult::DailyLimitExceeded: return "ERR DAILY_LIMIT daily withdrawal limit reached";
+            default:                                             return "ERR INTERNAL database error";
+        }
+    }
+}
+
+BankingServer::BankingServer(std::shared_ptr<BankingService> bankingService, int workers)
+    : service(std::move(bankingService)), workerCount(std::max(workers, 1)),
+      listenFd(-1), epollFd(-1), wakeFd(-1), signalFd(-1), stopping(false),
+      connectionsAccepted(0), requestsHandled(0) {}
+
+BankingServer::~BankingServer() {
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+    for (int fd : {listenFd, epollFd, wakeFd, signalFd}) {
+        if (fd != -1) {
+            close(fd);
+        }
+    }
+    if (!unixSocketPath.empty()) {
+        unlink(unixSocketPath.c_str());
+    }
+}
+
+bool BankingServer::listenOn(const std::string& address) {
+    size_t colon = address.rfind(':');
+    bool isTcp = address.find('/') == std::string::npos && colon != std::string::npos;
+
+    if (isTcp) {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(std::atoi(address.c_str() + colon + 1)));
+        if (inet_pton(AF_INET, address.substr(0, colon).c_str(), &addr.sin_addr) != 1 || addr.sin_port == 0) {
+            std::cerr << "Invalid TCP address: " << address << std::endl;
+            return false;
+        }
+
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) {
+            std::cerr << "Cannot create socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+            std::cerr << "Cannot bind " << address << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+    } else {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (address.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Socket path too long: " << address << std::endl;
+            return false;
+        }
+        std::strcpy(addr.sun_path, address.c_str());
+        unlink(address.c_str());   // stale socket from an earlier run
+
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd == -1) {
+            std::cerr << "Cannot create socket: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+            std::cerr << "Cannot bind " << address << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        unixSocketPath = address;
+    }
+
+    if (listen(listenFd, SOMAXCONN) == -1) {
+        std::cerr << "Cannot listen on " << address << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void BankingServer::run() {
+    // Shutdown signals arrive through the epoll set; block them before any
+    // worker exists so every thread inherits the mask
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (listenFd == -1 || epollFd == -1 || wakeFd == -1 || signalFd == -1) {
+        std::cerr << "Server setup failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    for (int fd : {listenFd, wakeFd, signalFd}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&BankingServer::workerLoop, this);
+    }
+    std::cout << "Serving with " << workerCount << " workers. Press Ctrl+C to stop." << std::endl;
+
+    epoll_event events[MAX_EVENTS];
+    bool running = true;
+    while (running) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                acceptConnections();
+            } else if (fd == wakeFd) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {
+                }
+                drainFlushRequests();
+            } else if (fd == signalFd) {
+                running = false;
+            } else {
+                auto it = connections.find(fd);
+                if (it == connections.end()) {
+                    continue;
+                }
+                ConnectionPtr connection = it->second;
+                if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                    closeConnection(connection);
+                    continue;
+                }
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                    readFromConnection(connection);
+                }
+                if (!connection->closed && (events[i].events & EPOLLOUT)) {
+                    flushConnection(connection);
+                }
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    std::cout << "Server stopped: " << connectionsAccepted << " connections, "
+              << requestsHandled << " requests." << std::endl;
+}
+
+// Event loop
+void BankingServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "accept failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            close(fd);
+            continue;
+        }
+        connections[fd] = std::make_shared<Connection>(fd);
+        ++connectionsAccepted;
+    }
+}
+
+void BankingServer::readFromConnection(const ConnectionPtr& connection) {
+    char buffer[4096];
+    bool endOfInput = false;
+    while (true) {
+        ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection->input.append(buffer, static_cast<size_t>(received));
+            continue;
+        }
+        if (received == 0) {
+            endOfInput = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(connection);
+            return;
+        }
+        break;
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        size_t start = 0;
+        size_t newline;
+        while (!connection->closing &&
+               (newline = connection->input.find('\n', start)) != std::string::npos) {
+            std::string line = connection->input.substr(start, newline - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            connection->pending.push_back(std::move(line));
+            start = newline + 1;
+        }
+        connection->input.erase(0, start);
+
+        if (connection->input.size() > MAX_REQUEST_LINE) {
+            connection->output += "ERR BAD_REQUEST line too long\n";
+            connection->closing = true;
+            connection->pending.clear();
+        }
+        // A client that half-closes after its last request still gets every answer
+        if (endOfInput) {
+            connection->readClosed = true;
+            connection->closing = true;
+        }
+        if (!connection->busy && !connection->pending.empty()) {
+            connection->busy = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        enqueue(connection);
+    }
+    flushConnection(connection);
+}
+
+void BankingServer::flushConnection(const ConnectionPtr& connection) {
+    bool closeNow = false;
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        if (connection->closed) {
+            return;
+        }
+
+        size_t sent = 0;
+        while (sent < connection->output.size()) {
+            ssize_t written = send(connection->fd, connection->output.data() + sent,
+                                   connection->output.size() - sent, MSG_NOSIGNAL);
+            if (written > 0) {
+                sent += static_cast<size_t>(written);
+            } else if (written == -1 && errno == EINTR) {
+                continue;
+            } else {
+                break;
+            }
+        }
+        connection->output.erase(0, sent);
+
+        // Only ask for EPOLLOUT while a response is stuck in the socket buffer
+        epoll_event event{};
+        uint32_t readEvents = EPOLLIN | EPOLLRDHUP;
+        uint32_t writeEvents = EPOLLOUT;
+        event.events = (connection->readClosed ? 0 : readEvents) | (connection->output.empty() ? 0 : writeEvents);
+        event.data.fd = connection->fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+
+        closeNow = connection->closing && !connection->busy && connection->output.empty();
+    }
+
+    if (closeNow) {
+        closeConnection(connection);
+    }
+}
+
+void BankingServer::closeConnection(const ConnectionPtr& connection) {
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        if (connection->closed) {
+            return;
+        }
+        connection->closed = true;
+        connection->pending.clear();
+    }
+    // A worker still holding the session only writes to the buffer, never the fd
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    close(connection->fd);
+    connections.erase(connection->fd);
+}
+
+void BankingServer::requestFlush(const ConnectionPtr& connection) {
+    {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        flushRequests.push_back(connection);
+    }
+    uint64_t one = 1;
+    ssize_t ignored = write(wakeFd, &one, sizeof(one));
+    (void)ignored;
+}
+
+void BankingServer::drainFlushRequests() {
+    std::vector<ConnectionPtr> ready;
+    {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        ready.swap(flushRequests);
+    }
+    for (const ConnectionPtr& connection : ready) {
+        flushConnection(connection);
+    }
+}
+
+// Worker pool
+void BankingServer::enqueue(const ConnectionPtr& connection) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        workQueue.push_back(connection);
+    }
+    queueReady.notify_one();
+}
+
+void BankingServer::workerLoop() {
+    while (true) {
+        ConnectionPtr connection;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this]() { return stopping || !workQueue.empty(); });
+            if (stopping) {
+                return;
+            }
+            connection = std::move(workQueue.front());
+            workQueue.pop_front();
+        }
+        serveConnection(connection);
+    }
+}
+
+// Drains one connection's requests in order. Only the worker that set busy
+// touches the session, so a Session never needs its own lock.
+void BankingServer::serveConnection(const ConnectionPtr& connection) {
+    while (true) {
+        std::string line;
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            if (connection->pending.empty() || connection->closed) {
+                connection->busy = false;
+                // The event loop can only close a draining connection once it is idle
+                if (connection->closing && !connection->closed) {
+                    requestFlush(connection);
+                }
+                break;
+            }
+            line = std::move(connection->pending.front());
+            connection->pending.pop_front();
+        }
+
+        bool closeAfter = false;
+        std::string response = handleRequest(connection->session, line, closeAfter);
+
+        {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            connection->output += response;
+            if (closeAfter) {
+                connection->closing = true;
+                connection->pending.clear();
+            }
+        }
+        ++requestsHandled;
+        requestFlush(connection);
+    }
+}
+
+std::string BankingServer::handleRequest(Session& session, const std::string& line, bool& closeAfter) {
+    std::istringstream fields(line);
+    std::vector<std::string> words;
+    std::string word;
+    while (fields >> word) {
+        words.push_back(word);
+    }
+    if (words.empty()) {
+        return "ERR BAD_REQUEST empty request\n";
+    }
+
+    std::string verb = words[0];
+    std::transform(verb.begin(), verb.end(), verb.begin(), toUpper);
+    size_t argumentCount = words.size() - 1;
+
+    if (verb == "PING" && argumentCount == 0) {
+        return "OK PONG\n";
+    }
+    if (verb == "QUIT" && argumentCount == 0) {
+        closeAfter = true;
+        return "OK BYE\n";
+    }
+    if ((verb == "LOGIN" || verb == "USE" || verb == "TRANSFER") && argumentCount >= 1 &&
+        !service->acceptsAccountNumber(words[1])) {
+        return "ERR BAD_REQUEST invalid account number\n";
+    }
+    if (verb == "LOGIN" && argumentCount == 2) {
+        if (!service->login(session, words[1], words[2])) {
+            return "ERR AUTH_FAILED invalid account number or PIN\n";
+        }
+        return "OK " + std::to_string(session.customerId) + "\n";
+    }
+
+    if (!session.isLoggedIn) {
+        return "ERR NOT_LOGGED_IN\n";
+    }
+
+    if (verb == "LOGOUT" && argumentCount == 0) {
+        service->logout(session);
+        return "OK\n";
+    }
+    if (verb == "USE" && argumentCount == 1) {
+        return service->useAccount(session, words[1]) ? "OK\n" : "ERR NO_ACCOUNT account not found for customer\n";
+    }
+    if (verb == "BALANCE" && argumentCount == 0) {
+        Money balance = service->getBalance(session);
+        return balance.isNegative() ? "ERR NO_ACCOUNT\n" : "OK " + balance.toString() + "\n";
+    }
+    if ((verb == "DEPOSIT" || verb == "WITHDRAW") && argumentCount == 1) {
+        Money amount;
+        if (!Money::parse(words[1], amount)) {
+            return "ERR BAD_REQUEST invalid amount\n";
+        }
+        Money newBalance;
+        Database::TransactionResult result = (verb == "DEPOSIT")
+            ? service->deposit(session, amount, newBalance)
+            : service->withdraw(session, amount, newBalance);
+        if (result != Database::TransactionResult::Success) {
+            return std::string(resultCode(result)) + "\n";
+        }
+        return "OK " + newBalance.toString() + "\n";
+    }
+    if (verb == "TRANSFER" && argumentCount == 2) {
+        Money amount;
+        if (!Money::parse(words[2], amount)) {
+            return "ERR BAD_REQUEST invalid amount\n";
+        }
+        if (!session.hasAccount()) {
+            return "ERR NO_ACCOUNT\n";
+        }
+        Money newBalance;
+        Database::TransactionResult result = service->transfer(session, words[1], amount, newBalance);
+        if (result == Database::TransactionResult::AccountNotFound) {
+            return "ERR NO_ACCOUNT destination account not found\n";
+        }
+        if (result != Database::TransactionResult::Success) {
+            return std::string(resultCode(result)) + "\n";
+        }
+        return "OK " + newBalance.toString() + "\n";
+    }
+    if (verb == "HISTORY" && argumentCount <= 2) {
+        long long cursor = 0;
+        if (argumentCount >= 1) {
+            const std::string& cursorText = words[1];
+            if (cursorText.empty() || cursorText.size() > 18 ||
+                !std::all_of(cursorText.begin(), cursorText.end(), isDigit)) {
+                return "ERR BAD_REQUEST cursor must be a transaction id\n";
+            }
+            cursor = std::atoll(cursorText.c_str());
+        }
+        Database::PageDirection direction = Database::PageDirection::Older;
+        if (argumentCount == 2) {
+            std::string directionText = words[2];
+            std::transform(directionText.begin(), directionText.end(), directionText.begin(), toUpper);
+            if (directionText == "NEWER") {
+                direction = Database::PageDirection::Newer;
+            } else if (directionText != "OLDER") {
+                return "ERR BAD_REQUEST direction must be OLDER or NEWER\n";
+            }
+        }
+        if (!session.hasAccount()) {
+            return "ERR NO_ACCOUNT\n";
+        }
+
+        Database::TransactionPage page = service->getHistoryPage(session, cursor, HISTORY_PAGE_SIZE, direction);
+        if (!page.loaded) {
+            return "ERR INTERNAL database error\n";
+        }
+        std::string response = "OK " + std::to_string(page.rows.size()) + " " +
+                               (page.hasOlder ? "1" : "0") + " " + (page.hasNewer ? "1" : "0") + "\n";
+        for (const Database::TransactionRow& row : page.rows) {
+            response += std::to_string(row.transactionId) + "\t" + AccountCodes::name(row.transactionType) + "\t" +
+                        row.amount.toString() + "\t" + row.balanceAfter.toString() + "\t" +
+                        row.transactionDate + "\t" + row.description + "\n";
+        }
+        return response;
+    }
+
+    return "ERR BAD_REQUEST unknown command or wrong arguments\n";
+}
@@ -0,0 +1,103 @@
+#ifndef BANKING_SERVER_H
+#define BANKING_SERVER_H
+
+#include "BankingService.h"
+#include "Session.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Local transaction server. One epoll thread owns every socket; a fixed pool
+// of workers runs the requests against the shared BankingService. Each
+// connection carries its own Session, and its requests run one at a time in
+// the order they arrived.
+//
+// Line protocol, one request per line, one response per request:
+//   LOGIN <account> <pin>      -> OK <customerId>
+//   USE <account>              -> OK
+//   BALANCE                    -> OK <amount>
+//   DEPOSIT <amount>           -> OK <newBalance>
+//   WITHDRAW <amount>          -> OK <newBalance>
+//   TRANSFER <account> <amount>-> OK <newBalance>
+//   HISTORY [cursor [OLDER|NEWER]]
+//                              -> OK <rows> <hasOlder> <hasNewer>, then <rows> lines of
+//                                 id<TAB>type<TAB>amount<TAB>balanceAfter<TAB>date<TAB>description
+//   LOGOUT | PING | QUIT       -> OK ...
+// Failures answer "ERR <CODE> <message>".
+class BankingServer {
+private:
+    struct Connection {
+        int fd;
+        Session session;
+        std::string input;                  // event loop only
+        bool readClosed = false;            // event loop only: peer sent EOF
+        std::mutex mutex;                   // guards everything below
+        std::deque<std::string> pending;
+        std::string output;
+        bool busy = false;                  // a worker owns the session right now
+        bool closing = false;               // close once output drains
+        bool closed = false;
+
+        explicit Connection(int socketFd) : fd(socketFd) {}
+    };
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    std::shared_ptr<BankingService> service;
+    int workerCount;
+
+    int listenFd;
+    int epollFd;
+    int wakeFd;                             // eventfd: workers -> event loop
+    int signalFd;
+    std::string unixSocketPath;             // unlinked on shutdown
+
+    std::unordered_map<int, ConnectionPtr> connections;
+
+    std::vector<std::thread> workers;
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<ConnectionPtr> workQueue;
+    bool stopping;
+
+    unsigned long long connectionsAccepted;
+    std::atomic<unsigned long long> requestsHandled;
+
+    std::mutex flushMutex;
+    std::vector<ConnectionPtr> flushRequests;
+
+    // Event loop
+    void acceptConnections();
+    void readFromConnection(const ConnectionPtr& connection);
+    void flushConnection(const ConnectionPtr& connection);
+    void closeConnection(const ConnectionPtr& connection);
+    void requestFlush(const ConnectionPtr& connection);
+    void drainFlushRequests();
+
+    // Worker pool
+    void enqueue(const ConnectionPtr& connection);
+    void workerLoop();
+    void serveConnection(const ConnectionPtr& connection);
+
+    std::string handleRequest(Session& session, const std::string& line, bool& closeAfter);
+
+public:
+    BankingServer(std::shared_ptr<BankingService> bankingService, int workers);
+    ~BankingServer();
+
+    BankingServer(const BankingServer&) = delete;
+    BankingServer& operator=(const BankingServer&) = delete;
+
+    // "/path/to/socket" for a Unix domain socket, "127.0.0.1:7070" for loopback TCP
+    bool listenOn(const std::string& address);
+
+    // Serves until SIGINT or SIGTERM
+    void run();
+};
+
+#endif
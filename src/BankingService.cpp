@@ -0,0 +1,244 @@
+#include "BankingService.h"
+
+const Money BankingService::MAX_WITHDRAWAL_AMOUNT = Money::fromMajorUnits(10000);
+const Money BankingService::MIN_TRANSACTION_AMOUNT = Money::fromMajorUnits(1);
+const Money BankingService::MAX_DAILY_WITHDRAWAL = Money::fromMajorUnits(50000);
+const Money BankingService::LOW_BALANCE_ALERT = Money::fromMajorUnits(100);
+
+BankingService::BankingService(const std::string& dbPath, const std::string& profileName) {
+    database = std::make_unique<Database>(dbPath, profileName);
+}
+
+BankingService::~BankingService() = default;
+
+bool BankingService::initialize() {
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    database->setDailyWithdrawalLimit(MAX_DAILY_WITHDRAWAL);
+    return database->isConnected() || database->connect();
+}
+
+void BankingService::enableGroupCommit(size_t maxBatchOps, std::chrono::microseconds maxDelay) {
+    writeQueue.reset();
+    if (maxBatchOps > 0) {
+        writeQueue = std::make_unique<WriteQueue>(*database, databaseMutex, maxBatchOps, maxDelay);
+    }
+}
+
+bool BankingService::getGroupCommitStats(WriteQueue::Stats& stats) const {
+    if (!writeQueue) {
+        return false;
+    }
+    stats = writeQueue->getStats();
+    return true;
+}
+
+AccountLockManager::Stats BankingService::getAccountLockStats() const {
+    return accountLocks.getStats();
+}
+
+std::vector<AccountLockManager::HotAccount> BankingService::getHotAccounts(size_t limit) const {
+    return accountLocks.getHotAccounts(limit);
+}
+
+Database::AccountCacheStats BankingService::getAccountCacheStats() const {
+    return database->getAccountCacheStats();
+}
+
+Database::TransactionResult BankingService::awaitWrite(std::future<WriteQueue::Result> pending, Money& newBalance) {
+    WriteQueue::Result written = pending.get();
+    if (written.result == Database::TransactionResult::Success) {
+        newBalance = written.balanceAfter;
+    }
+    return written.result;
+}
+
+bool BankingService::isValidWithdrawalAmount(Money amount) {
+    return amount >= MIN_TRANSACTION_AMOUNT && amount <= MAX_WITHDRAWAL_AMOUNT;
+}
+
+std::unique_lock<std::mutex> BankingService::lockForRead() const {
+    if (database->hasReaderPool()) {
+        return std::unique_lock<std::mutex>();
+    }
+    return std::unique_lock<std::mutex>(databaseMutex);
+}
+
+// Customers
+bool BankingService::registerCustomer(const std::string& firstName, const std::string& middleName,
+                                      const std::string& lastName, const std::string& email,
+                                      const std::string& phoneNumber, const std::string& address,
+                                      const std::string& dob, const std::string& pin, int* customerId) {
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    return database->insertCustomer(firstName, middleName, lastName, email, phoneNumber, address, dob, pin,
+                                    customerId);
+}
+
+// Session lifecycle
+bool BankingService::login(Session& session, const std::string& accountNumber, const std::string& pin) {
+    if (!database->acceptsAccountNumber(accountNumber)) {
+        return false;
+    }
+    int customerId;
+    {
+        std::lock_guard<std::mutex> lock(databaseMutex);
+        customerId = database->getCustomerIdByAccountNumber(accountNumber);
+        if (customerId == -1 || !database->validateCustomerLogin(customerId, pin)) {
+            return false;
+        }
+    }
+
+    session.customerId = customerId;
+    session.accountNumber = accountNumber;
+    session.isLoggedIn = true;
+    return true;
+}
+
+bool BankingService::acceptsAccountNumber(const std::string& accountNumber) const {
+    return database->acceptsAccountNumber(accountNumber);
+}
+
+void BankingService::logout(Session& session) {
+    session = Session();
+}
+
+bool BankingService::useAccount(Session& session, const std::string& accountNumber) {
+    if (!session.isLoggedIn || !database->acceptsAccountNumber(accountNumber)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(databaseMutex);
+        if (database->getCustomerIdByAccountNumber(accountNumber) != session.customerId) {
+            return false;
+        }
+    }
+
+    session.accountNumber = accountNumber;
+    return true;
+}
+
+// Reads
+Database::CustomerInfo BankingService::getCustomerInfo(const Session& session) {
+    std::unique_lock<std::mutex> lock = lockForRead();
+    return database->getCustomerInfo(session.customerId);
+}
+
+std::vector<Database::AccountRow> BankingService::getCustomerAccounts(const Session& session) {
+    if (!session.isLoggedIn) {
+        return std::vector<Database::AccountRow>();
+    }
+    std::unique_lock<std::mutex> lock = lockForRead();
+    return database->getCustomerAccounts(session.customerId);
+}
+
+AccountType BankingService::getAccountType(const Session& session) {
+    if (!session.hasAccount()) {
+        return AccountType::Unknown;
+    }
+    std::unique_lock<std::mutex> lock = lockForRead();
+    return database->getAccountType(session.accountNumber);
+}
+
+Money BankingService::getBalance(const Session& session) {
+    if (!session.hasAccount()) {
+        return Money::fromMajorUnits(-1);
+    }
+    std::unique_lock<std::mutex> lock = lockForRead();
+    return database->getAccountBalance(session.accountNumber);
+}
+
+Money BankingService::getWithdrawnToday(const Session& session) {
+    if (!session.hasAccount()) {
+        return Money();
+    }
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    return database->getDailyWithdrawalTotal(session.accountNumber);
+}
+
+Database::TransactionPage BankingService::getHistoryPage(const Session& session, long long cursor, int pageSize,
+                                                         Database::PageDirection direction) {
+    if (!session.hasAccount()) {
+        return Database::TransactionPage();
+    }
+    std::unique_lock<std::mutex> lock = lockForRead();
+    return database->getTransactionPage(session.accountNumber, cursor, pageSize, direction);
+}
+
+// Money movement
+bool BankingService::openAccount(Session& session, AccountType accountType, Money initialDeposit,
+                                 std::string* accountNumber) {
+    if (!session.isLoggedIn || (accountType != AccountType::Savings && accountType != AccountType::Checkings) ||
+        initialDeposit < MIN_TRANSACTION_AMOUNT) {
+        return false;
+    }
+
+    std::string createdAccountNumber;
+    {
+        std::lock_guard<std::mutex> lock(databaseMutex);
+        if (!database->createAccount(session.customerId, accountType, initialDeposit, &createdAccountNumber)) {
+            return false;
+        }
+    }
+
+    // A customer's first account becomes the active one
+    if (session.accountNumber.empty()) {
+        session.accountNumber = createdAccountNumber;
+    }
+    if (accountNumber) {
+        *accountNumber = createdAccountNumber;
+    }
+    return true;
+}
+
+Database::TransactionResult BankingService::deposit(const Session& session, Money amount, Money& newBalance) {
+    if (!session.hasAccount()) {
+        return Database::TransactionResult::AccountNotFound;
+    }
+    if (amount < MIN_TRANSACTION_AMOUNT) {
+        return Database::TransactionResult::InvalidAmount;
+    }
+    AccountLockManager::Guard accountLock = accountLocks.lock(session.accountNumber);
+    if (writeQueue) {
+        return awaitWrite(writeQueue->submitTransaction(session.accountNumber, TransactionType::Deposit, amount,
+                                                        "Cash deposit"), newBalance);
+    }
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    return database->applyTransaction(session.accountNumber, TransactionType::Deposit, amount, "Cash deposit",
+                                      newBalance);
+}
+
+Database::TransactionResult BankingService::withdraw(const Session& session, Money amount, Money& newBalance) {
+    if (!session.hasAccount()) {
+        return Database::TransactionResult::AccountNotFound;
+    }
+    if (!isValidWithdrawalAmount(amount)) {
+        return Database::TransactionResult::InvalidAmount;
+    }
+    AccountLockManager::Guard accountLock = accountLocks.lock(session.accountNumber);
+    if (writeQueue) {
+        return awaitWrite(writeQueue->submitTransaction(session.accountNumber, TransactionType::Withdrawal, amount,
+                                                        "Cash withdrawal"), newBalance);
+    }
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    return database->applyTransaction(session.accountNumber, TransactionType::Withdrawal, amount,
+                                      "Cash withdrawal", newBalance);
+}
+
+Database::TransactionResult BankingService::transfer(const Session& session, const std::string& toAccount,
+                                                     Money amount, Money& newBalance) {
+    if (!session.hasAccount()) {
+        return Database::TransactionResult::AccountNotFound;
+    }
+    if (amount < MIN_TRANSACTION_AMOUNT) {
+        return Database::TransactionResult::InvalidAmount;
+    }
+    if (!database->acceptsAccountNumber(toAccount)) {
+        return Database::TransactionResult::AccountNotFound;
+    }
+    AccountLockManager::Guard accountLock = accountLocks.lock(session.accountNumber, toAccount);
+    if (writeQueue) {
+        return awaitWrite(writeQueue->submitTransfer(session.accountNumber, toAccount, amount, ""), newBalance);
+    }
+    std::lock_guard<std::mutex> lock(databaseMutex);
+    return database->transferFunds(session.accountNumber, toAccount, amount, "", newBalance);
+}
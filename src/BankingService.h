@@ -0,0 +1,96 @@
+#ifndef BANKING_SERVICE_H
+#define BANKING_SERVICE_H
+
+#include "AccountLocks.h"
+#include "Database.h"
+#include "Session.h"
+#include "WriteQueue.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Thread-safe banking operations over an explicit Session. All business
+// rules (limits, ownership checks) live here; front ends only render.
+// Every call may come from any thread. Writes are serialized on the writer
+// connection; balance, history and customer reads run in parallel on the
+// Database's reader pool when it has one. Deposits, withdrawals and
+// transfers also hold their accounts' locks until the write commits, so
+// work on one account runs one at a time in arrival order.
+class BankingService {
+private:
+    std::unique_ptr<Database> database;
+    mutable std::mutex databaseMutex;
+    AccountLockManager accountLocks;
+    std::unique_ptr<WriteQueue> writeQueue;     // declared after database so it drains first
+    
+    static bool isValidWithdrawalAmount(Money amount);
+    static Database::TransactionResult awaitWrite(std::future<WriteQueue::Result> pending, Money& newBalance);
+    
+    // Holds the writer lock only when reads would otherwise share the writer connection
+    std::unique_lock<std::mutex> lockForRead() const;
+    
+public:
+    // Transaction limits
+    static const Money MAX_WITHDRAWAL_AMOUNT;
+    static const Money MIN_TRANSACTION_AMOUNT;
+    static const Money MAX_DAILY_WITHDRAWAL;
+    static const Money LOW_BALANCE_ALERT;
+    
+    BankingService(const std::string& dbPath = "bank_system.db", const std::string& profileName = "");
+    ~BankingService();
+    
+    BankingService(const BankingService&) = delete;
+    BankingService& operator=(const BankingService&) = delete;
+    
+    // Connects on first call; later calls are no-ops
+    bool initialize();
+    
+    // Routes deposits, withdrawals and transfers through a group-commit
+    // WriteQueue. Each call still returns only once its write is committed.
+    // Call after initialize(); maxBatchOps 0 turns it back off.
+    void enableGroupCommit(size_t maxBatchOps, std::chrono::microseconds maxDelay);
+    bool getGroupCommitStats(WriteQueue::Stats& stats) const;    // false when group commit is off
+    
+    // Per-account lock contention since startup
+    AccountLockManager::Stats getAccountLockStats() const;
+    std::vector<AccountLockManager::HotAccount> getHotAccounts(size_t limit) const;
+    
+    // Account and customer reads served from the data layer's cache since startup
+    Database::AccountCacheStats getAccountCacheStats() const;
+    
+    // Customers
+    bool registerCustomer(const std::string& firstName, const std::string& middleName,
+                          const std::string& lastName, const std::string& email,
+                          const std::string& phoneNumber, const std::string& address,
+                          const std::string& dob, const std::string& pin, int* customerId = nullptr);
+    
+    // Session lifecycle
+    bool login(Session& session, const std::string& accountNumber, const std::string& pin);
+    void logout(Session& session);
+    bool useAccount(Session& session, const std::string& accountNumber);   // must belong to the session's customer
+    
+    // Check-digit test for typed account numbers; needs no query or lock
+    bool acceptsAccountNumber(const std::string& accountNumber) const;
+    
+    // Reads for the session's customer and selected account
+    Database::CustomerInfo getCustomerInfo(const Session& session);
+    std::vector<Database::AccountRow> getCustomerAccounts(const Session& session);
+    AccountType getAccountType(const Session& session);
+    Money getBalance(const Session& session);                 // -1.00 when no account is selected
+    Money getWithdrawnToday(const Session& session);          // counts towards MAX_DAILY_WITHDRAWAL
+    Database::TransactionPage getHistoryPage(const Session& session, long long cursor, int pageSize,
+                                             Database::PageDirection direction);
+    
+    // Money movement
+    bool openAccount(Session& session, AccountType accountType, Money initialDeposit,
+                     std::string* accountNumber = nullptr);
+    Database::TransactionResult deposit(const Session& session, Money amount, Money& newBalance);
+    Database::TransactionResult withdraw(const Session& session, Money amount, Money& newBalance);
+    // From the session's account to any active account; newBalance is the source balance
+    Database::TransactionResult transfer(const Session& session, const std::string& toAccount, Money amount,
+                                         Money& newBalance);
+};
+
+#endif
@@ -7,19 +7,19 @@
 #include <thread>
 #include <chrono>
 
-const double BankingSystem::MAX_WITHDRAWAL_AMOUNT = 10000.0;
-const double BankingSystem::MIN_TRANSACTION_AMOUNT = 1.0;
-const double BankingSystem::MAX_DAILY_WITHDRAWAL = 50000.0;
+const int BankingSystem::HISTORY_PAGE_SIZE = 10;
 
-BankingSystem::BankingSystem() : currentCustomerId(-1), isLoggedIn(false) {
-    database = std::make_unique<Database>();
-}
+BankingSystem::BankingSystem(const std::string& dbPath, const std::string& profileName)
+    : service(std::make_shared<BankingService>(dbPath, profileName)) {}
+
+BankingSystem::BankingSystem(std::shared_ptr<BankingService> sharedService)
+    : service(std::move(sharedService)) {}
 
 BankingSystem::~BankingSystem() = default;
 
 bool BankingSystem::initialize() {
     std::cout << "Initializing KNUST Banking System..." << std::endl;
-    if (!database->connect()) {
+    if (!service->initialize()) {
         std::cerr << "Failed to connect to database!" << std::endl;
         return false;
     }
@@ -47,7 +47,7 @@ void BankingSystem::run() {
     }
     
     while (true) {
-        if (!isLoggedIn) {
+        if (!session.isLoggedIn) {
             displayWelcomeMenu();
         } else {
             displayMainMenu();
@@ -93,14 +93,13 @@ void BankingSystem::displayMainMenu() {
     clearScreen();
     displayHeader("ATANGA BANK - ONLINE BANKING");
     
-    Database::CustomerInfo customer = database->getCustomerInfo(currentCustomerId);
+    Database::CustomerInfo customer = service->getCustomerInfo(session);
     std::cout << "\n Welcome back, " << getFullName(customer) << "!" << std::endl;
     
-    if (!currentAccountNumber.empty()) {
-        std::cout << " Active Account: " << currentAccountNumber 
-                  << " (" << database->getAccountType(currentAccountNumber) << ")" << std::endl;
-        std::cout << " Current Balance: $" << std::fixed << std::setprecision(2) 
-                  << database->getAccountBalance(currentAccountNumber) << std::endl;
+    if (!session.accountNumber.empty()) {
+        std::cout << " Active Account: " << session.accountNumber 
+                  << " (" << AccountCodes::name(service->getAccountType(session)) << ")" << std::endl;
+        std::cout << " Current Balance: $" << currentBalance() << std::endl;
     }
     
     std::cout << "\n Banking Services:" << std::endl;
@@ -173,8 +172,16 @@ bool BankingSystem::isValidPin(const std::string& pin) const {
     return pin.length() == 4 && std::all_of(pin.begin(), pin.end(), ::isdigit);
 }
 
-bool BankingSystem::isValidAmount(double amount) const {
-    return amount >= MIN_TRANSACTION_AMOUNT && amount <= MAX_WITHDRAWAL_AMOUNT;
+Money BankingSystem::readAmount() const {
+    std::string input;
+    std::getline(std::cin, input);
+    
+    // Anything unparseable reads as zero and fails the minimum-amount check
+    Money amount;
+    if (!Money::parse(input, amount)) {
+        return Money();
+    }
+    return amount;
 }
 
 bool BankingSystem::createCustomerAccount() {
@@ -233,7 +240,7 @@ bool BankingSystem::createCustomerAccount() {
         }
     } while (!isValidPin(pin) || pin != confirmPin);
     
-    if (database->insertCustomer(firstName, middleName, lastName, email, phoneNumber, address, dob, pin)) {
+    if (service->registerCustomer(firstName, middleName, lastName, email, phoneNumber, address, dob, pin)) {
         std::cout << "\n Customer account created successfully!" << std::endl;
         std::cout << " Welcome to KNUST Bank family!" << std::endl;
         
@@ -287,15 +294,17 @@ bool BankingSystem::loginCustomer() {
     std::cout << "\nAccount Number: ";
     std::getline(std::cin, accountNumber);
     
+    if (!acceptsAccountNumber(accountNumber)) {
+        std::cout << "\n Invalid account number. Please check the digits and try again." << std::endl;
+        std::cout << "\nPress Enter to continue...";
+        std::cin.get();
+        return false;
+    }
+    
     std::cout << "PIN: ";
     std::getline(std::cin, pin);
     
-    int customerId = database->getCustomerIdByAccountNumber(accountNumber);
-    if (customerId != -1 && database->validateCustomerLogin(customerId, pin)) {
-        currentCustomerId = customerId;
-        currentAccountNumber = accountNumber;
-        isLoggedIn = true;
-        
+    if (login(accountNumber, pin)) {
         std::cout << "\n Login successful!" << std::endl;
         std::cout << " Welcome to KNUST Bank Online Banking!" << std::endl;
         
@@ -311,9 +320,7 @@ bool BankingSystem::loginCustomer() {
 }
 
 void BankingSystem::logout() {
-    currentCustomerId = -1;
-    currentAccountNumber = "";
-    isLoggedIn = false;
+    endSession();
     
     clearScreen();
     displayHeader("LOGOUT SUCCESSFUL");
@@ -323,11 +330,45 @@ void BankingSystem::logout() {
     std::this_thread::sleep_for(std::chrono::seconds(3));
 }
 
+// Non-interactive core
+bool BankingSystem::login(const std::string& accountNumber, const std::string& pin) {
+    return service->login(session, accountNumber, pin);
+}
+
+void BankingSystem::endSession() {
+    service->logout(session);
+}
+
+bool BankingSystem::useAccount(const std::string& accountNumber) {
+    return service->useAccount(session, accountNumber);
+}
+
+Money BankingSystem::currentBalance() const {
+    return service->getBalance(session);
+}
+
+Database::TransactionResult BankingSystem::depositAmount(Money amount, Money& newBalance) {
+    return service->deposit(session, amount, newBalance);
+}
+
+Database::TransactionResult BankingSystem::withdrawAmount(Money amount, Money& newBalance) {
+    return service->withdraw(session, amount, newBalance);
+}
+
+Database::TransactionResult BankingSystem::transferAmount(const std::string& toAccount, Money amount,
+                                                         Money& newBalance) {
+    return service->transfer(session, toAccount, amount, newBalance);
+}
+
+Database::TransactionPage BankingSystem::historyPage(long long cursor, Database::PageDirection direction) const {
+    return service->getHistoryPage(session, cursor, HISTORY_PAGE_SIZE, direction);
+}
+
 void BankingSystem::selectAccount() {
     clearScreen();
     displayHeader("SELECT ACCOUNT");
     
-    std::vector<std::string> accounts = database->getCustomerAccounts(currentCustomerId);
+    std::vector<Database::AccountRow> accounts = service->getCustomerAccounts(session);
     
     if (accounts.empty()) {
         std::cout << "\n No accounts found." << std::endl;
@@ -344,12 +385,10 @@ void BankingSystem::selectAccount() {
     std::cin >> choice;
     std::cin.ignore();
     
-    if (choice >= 1 && choice <= accounts.size()) {
-        std::string selectedAccount = accounts[choice - 1];
-        size_t pos = selectedAccount.find('|');
-        currentAccountNumber = selectedAccount.substr(0, pos);
+    if (choice >= 1 && choice <= static_cast<int>(accounts.size()) &&
+        useAccount(accounts[choice - 1].accountNumber)) {
         
-        std::cout << "\n Account selected: " << currentAccountNumber << std::endl;
+        std::cout << "\n Account selected: " << session.accountNumber << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
     } else {
@@ -359,21 +398,15 @@ void BankingSystem::selectAccount() {
     }
 }
 
-void BankingSystem::displayAccountSelectionMenu(const std::vector<std::string>& accounts) const {
+void BankingSystem::displayAccountSelectionMenu(const std::vector<Database::AccountRow>& accounts) const {
     std::cout << "\n Your Bank Accounts:" << std::endl;
     std::cout << std::string(60, '-') << std::endl;
     
     for (size_t i = 0; i < accounts.size(); ++i) {
-        std::string account = accounts[i];
-        size_t pos1 = account.find('|');
-        size_t pos2 = account.find('|', pos1 + 1);
+        const Database::AccountRow& account = accounts[i];
         
-        std::string accountNumber = account.substr(0, pos1);
-        std::string accountType = account.substr(pos1 + 1, pos2 - pos1 - 1);
-        std::string balance = account.substr(pos2 + 1);
-        
-        std::cout << (i + 1) << ".  " << accountNumber << " (" << accountType << ")"
-                  << "\n    Balance: $" << std::fixed << std::setprecision(2) << std::stod(balance) << std::endl;
+        std::cout << (i + 1) << ".  " << account.accountNumber << " (" << AccountCodes::name(account.accountType) << ")"
+                  << "\n    Balance: $" << account.balance << std::endl;
         std::cout << std::string(40, '-') << std::endl;
     }
 }
@@ -382,7 +415,8 @@ bool BankingSystem::createBankAccount(const std::string& accountType) {
     clearScreen();
     displayHeader("OPEN NEW BANK ACCOUNT");
     
-    if (accountType != "Savings" && accountType != "Checkings") {
+    AccountType type = AccountCodes::parseAccountType(accountType);
+    if (type != AccountType::Savings && type != AccountType::Checkings) {
         std::cout << " Invalid account type. Please choose Savings or Checkings." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
@@ -391,29 +425,26 @@ bool BankingSystem::createBankAccount(const std::string& accountType) {
     
     std::cout << "\n Opening " << accountType << " Account..." << std::endl;
     
-    double initialDeposit = 0.0;
-    std::cout << "\nMinimum opening deposit: $" << MIN_TRANSACTION_AMOUNT << std::endl;
+    std::cout << "\nMinimum opening deposit: $" << BankingService::MIN_TRANSACTION_AMOUNT << std::endl;
     std::cout << "Enter initial deposit amount: $";
-    std::cin >> initialDeposit;
-    std::cin.ignore();
+    Money initialDeposit = readAmount();
     
-    if (initialDeposit < MIN_TRANSACTION_AMOUNT) {
-        std::cout << " Initial deposit must be at least $" << MIN_TRANSACTION_AMOUNT << std::endl;
+    if (initialDeposit < BankingService::MIN_TRANSACTION_AMOUNT) {
+        std::cout << " Initial deposit must be at least $" << BankingService::MIN_TRANSACTION_AMOUNT << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
         return false;
     }
     
-    if (database->createAccount(currentCustomerId, accountType, initialDeposit)) {
+    bool hadAccount = !session.accountNumber.empty();
+    std::string accountNumber;
+    if (service->openAccount(session, type, initialDeposit, &accountNumber)) {
         std::cout << "\n " << accountType << " account opened successfully!" << std::endl;
-        std::cout << " Initial deposit: $" << std::fixed << std::setprecision(2) << initialDeposit << std::endl;
+        std::cout << " Initial deposit: $" << initialDeposit << std::endl;
         
-        // Auto-select the new account if it's the first one
-        std::vector<std::string> accounts = database->getCustomerAccounts(currentCustomerId);
-        if (accounts.size() == 1) {
-            size_t pos = accounts[0].find('|');
-            currentAccountNumber = accounts[0].substr(0, pos);
-            std::cout << " Account automatically selected: " << currentAccountNumber << std::endl;
+        // The service selects a customer's first account automatically
+        if (!hadAccount) {
+            std::cout << " Account automatically selected: " << accountNumber << std::endl;
         }
         
         std::cout << "\n Welcome to KNUST Bank family!" << std::endl;
@@ -427,7 +458,7 @@ bool BankingSystem::createBankAccount(const std::string& accountType) {
 }
 
 void BankingSystem::deposit() {
-    if (currentAccountNumber.empty()) {
+    if (session.accountNumber.empty()) {
         std::cout << " Please select an account first." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
@@ -437,26 +468,24 @@ void BankingSystem::deposit() {
     clearScreen();
     displayHeader("DEPOSIT MONEY");
     
-    double currentBalance = database->getAccountBalance(currentAccountNumber);
-    std::cout << "\n Account: " << currentAccountNumber << std::endl;
-    std::cout << " Current Balance: $" << std::fixed << std::setprecision(2) << currentBalance << std::endl;
+    Money balance = currentBalance();
+    std::cout << "\n Account: " << session.accountNumber << std::endl;
+    std::cout << " Current Balance: $" << balance << std::endl;
     
-    double amount;
     std::cout << "\n Enter deposit amount: $";
-    std::cin >> amount;
-    std::cin.ignore();
+    Money amount = readAmount();
     
-    if (amount < MIN_TRANSACTION_AMOUNT) {
-        std::cout << " Minimum deposit amount is $" << MIN_TRANSACTION_AMOUNT << std::endl;
+    if (amount < BankingService::MIN_TRANSACTION_AMOUNT) {
+        std::cout << " Minimum deposit amount is $" << BankingService::MIN_TRANSACTION_AMOUNT << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
         return;
     }
     
-    double newBalance = currentBalance + amount;
+    Money newBalance;
+    Database::TransactionResult result = depositAmount(amount, newBalance);
     
-    if (database->updateAccountBalance(currentAccountNumber, newBalance) &&
-        database->recordTransaction(currentAccountNumber, "DEPOSIT", amount, newBalance, "Cash deposit")) {
+    if (result == Database::TransactionResult::Success) {
         
         displayTransactionReceipt("DEPOSIT", amount, newBalance);
         std::cout << "\n Deposit successful!" << std::endl;
@@ -470,7 +499,7 @@ void BankingSystem::deposit() {
 }
 
 void BankingSystem::withdraw() {
-    if (currentAccountNumber.empty()) {
+    if (session.accountNumber.empty()) {
         std::cout << " Please select an account first." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
@@ -480,47 +509,46 @@ void BankingSystem::withdraw() {
     clearScreen();
     displayHeader("WITHDRAW MONEY");
     
-    double currentBalance = database->getAccountBalance(currentAccountNumber);
-    std::cout << "\n Account: " << currentAccountNumber << std::endl;
-    std::cout << " Available Balance: $" << std::fixed << std::setprecision(2) << currentBalance << std::endl;
-    std::cout << " Daily withdrawal limit: $" << MAX_WITHDRAWAL_AMOUNT << std::endl;
+    Money balance = currentBalance();
+    std::cout << "\n Account: " << session.accountNumber << std::endl;
+    std::cout << " Available Balance: $" << balance << std::endl;
+    std::cout << " Per-withdrawal limit: $" << BankingService::MAX_WITHDRAWAL_AMOUNT << std::endl;
+    std::cout << " Withdrawn today: $" << service->getWithdrawnToday(session)
+              << " of $" << BankingService::MAX_DAILY_WITHDRAWAL << std::endl;
     
-    double amount;
     std::cout << "\n Enter withdrawal amount: $";
-    std::cin >> amount;
-    std::cin.ignore();
+    Money amount = readAmount();
     
-    if (amount < MIN_TRANSACTION_AMOUNT) {
-        std::cout << " Minimum withdrawal amount is $" << MIN_TRANSACTION_AMOUNT << std::endl;
+    if (amount < BankingService::MIN_TRANSACTION_AMOUNT) {
+        std::cout << " Minimum withdrawal amount is $" << BankingService::MIN_TRANSACTION_AMOUNT << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
         return;
     }
     
-    if (amount > MAX_WITHDRAWAL_AMOUNT) {
-        std::cout << " Maximum withdrawal amount is $" << MAX_WITHDRAWAL_AMOUNT << std::endl;
+    if (amount > BankingService::MAX_WITHDRAWAL_AMOUNT) {
+        std::cout << " Maximum withdrawal amount is $" << BankingService::MAX_WITHDRAWAL_AMOUNT << std::endl;
         std::cout << "Please contact the bank for larger withdrawals." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
         return;
     }
     
-    if (amount > currentBalance) {
-        std::cout << " Insufficient funds!" << std::endl;
-        std::cout << " Your available balance is: $" << std::fixed << std::setprecision(2) << currentBalance << std::endl;
-        std::cout << "Press Enter to continue...";
-        std::cin.get();
-        return;
-    }
-    
-    double newBalance = currentBalance - amount;
+    Money newBalance;
+    Database::TransactionResult result = withdrawAmount(amount, newBalance);
     
-    if (database->updateAccountBalance(currentAccountNumber, newBalance) &&
-        database->recordTransaction(currentAccountNumber, "WITHDRAWAL", amount, newBalance, "Cash withdrawal")) {
+    if (result == Database::TransactionResult::Success) {
         
         displayTransactionReceipt("WITHDRAWAL", amount, newBalance);
         std::cout << "\n Withdrawal successful!" << std::endl;
         std::cout << " Please collect your cash from the dispenser." << std::endl;
+    } else if (result == Database::TransactionResult::InsufficientFunds) {
+        // Checked by the balance UPDATE itself, so it holds even if another session moved money meanwhile
+        std::cout << " Insufficient funds!" << std::endl;
+        std::cout << " Your available balance is: $" << currentBalance() << std::endl;
+    } else if (result == Database::TransactionResult::DailyLimitExceeded) {
+        std::cout << " Daily withdrawal limit of $" << BankingService::MAX_DAILY_WITHDRAWAL << " reached." << std::endl;
+        std::cout << " You have withdrawn $" << service->getWithdrawnToday(session) << " today." << std::endl;
     } else {
         std::cout << " Withdrawal failed. Please try again." << std::endl;
     }
@@ -530,7 +558,7 @@ void BankingSystem::withdraw() {
 }
 
 void BankingSystem::checkBalance() const {
-    if (currentAccountNumber.empty()) {
+    if (session.accountNumber.empty()) {
         std::cout << " Please select an account first." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
@@ -540,14 +568,14 @@ void BankingSystem::checkBalance() const {
     clearScreen();
     displayHeader("ACCOUNT BALANCE");
     
-    double balance = database->getAccountBalance(currentAccountNumber);
-    std::string accountType = database->getAccountType(currentAccountNumber);
+    Money balance = currentBalance();
+    AccountType accountType = service->getAccountType(session);
     
-    std::cout << "\n Account Number: " << currentAccountNumber << std::endl;
-    std::cout << " Account Type: " << accountType << std::endl;
-    std::cout << " Current Balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
+    std::cout << "\n Account Number: " << session.accountNumber << std::endl;
+    std::cout << " Account Type: " << AccountCodes::name(accountType) << std::endl;
+    std::cout << " Current Balance: $" << balance << std::endl;
     
-    if (balance < 100) {
+    if (balance < BankingService::LOW_BALANCE_ALERT) {
         std::cout << "\n  Low balance alert! Consider making a deposit." << std::endl;
     }
     
@@ -556,25 +584,34 @@ void BankingSystem::checkBalance() const {
 }
 
 void BankingSystem::viewTransactionHistory() const {
-    if (currentAccountNumber.empty()) {
+    if (session.accountNumber.empty()) {
         std::cout << " Please select an account first." << std::endl;
         std::cout << "Press Enter to continue...";
         std::cin.get();
         return;
     }
     
-    clearScreen();
-    displayHeader("TRANSACTION HISTORY");
-    
-    std::cout << "\n Account: " << currentAccountNumber << std::endl;
-    std::cout << " Last 10 Transactions" << std::endl;
-    std::cout << std::string(90, '-') << std::endl;
-    
-    std::vector<std::string> transactions = database->getTransactionHistory(currentAccountNumber, 10);
+    long long cursor = 0;
+    Database::PageDirection direction = Database::PageDirection::Older;
+    Database::TransactionPage page = historyPage(cursor, direction);
     
-    if (transactions.empty()) {
-        std::cout << " No transaction history available." << std::endl;
-    } else {
+    while (true) {
+        clearScreen();
+        displayHeader("TRANSACTION HISTORY");
+        
+        std::cout << "\n Account: " << session.accountNumber << std::endl;
+        std::cout << " Transactions (" << HISTORY_PAGE_SIZE << " per page)" << std::endl;
+        std::cout << std::string(90, '-') << std::endl;
+        
+        if (!page.loaded) {
+            std::cout << " Could not load transaction history." << std::endl;
+        } else if (page.rows.empty()) {
+            std::cout << " No transaction history available." << std::endl;
+            std::cout << "\nPress Enter to continue...";
+            std::cin.get();
+            return;
+        }
+        
         std::cout << std::left << std::setw(12) << "Type" 
                   << std::setw(12) << "Amount" 
                   << std::setw(15) << "Balance After"
@@ -582,46 +619,108 @@ void BankingSystem::viewTransactionHistory() const {
                   << "Date/Time" << std::endl;
         std::cout << std::string(90, '-') << std::endl;
         
-        for (const auto& transaction : transactions) {
-            size_t pos1 = transaction.find('|');
-            size_t pos2 = transaction.find('|', pos1 + 1);
-            size_t pos3 = transaction.find('|', pos2 + 1);
-            size_t pos4 = transaction.find('|', pos3 + 1);
-            
-            std::string type = transaction.substr(0, pos1);
-            std::string amount = transaction.substr(pos1 + 1, pos2 - pos1 - 1);
-            std::string balanceAfter = transaction.substr(pos2 + 1, pos3 - pos2 - 1);
-            std::string description = transaction.substr(pos3 + 1, pos4 - pos3 - 1);
-            std::string date = transaction.substr(pos4 + 1);
+        for (const auto& transaction : page.rows) {
+            std::string emoji = (transaction.transactionType == TransactionType::Deposit) ? "📥" : "📤";
             
-            std::string emoji = (type == "DEPOSIT") ? "📥" : "📤";
-            
-            std::cout << std::left << emoji << std::setw(10) << type 
-                      << "$" << std::setw(11) << std::fixed << std::setprecision(2) << std::stod(amount)
-                      << "$" << std::setw(14) << std::fixed << std::setprecision(2) << std::stod(balanceAfter)
-                      << std::setw(25) << description
-                      << date << std::endl;
+            std::cout << std::left << emoji << std::setw(10) << AccountCodes::name(transaction.transactionType) 
+                      << "$" << std::setw(11) << transaction.amount
+                      << "$" << std::setw(14) << transaction.balanceAfter
+                      << std::setw(25) << transaction.description
+                      << transaction.transactionDate << std::endl;
+        }
+        
+        std::cout << std::string(90, '-') << std::endl;
+        if (page.hasNewer) {
+            std::cout << "[P] Newer  ";
+        }
+        if (page.hasOlder) {
+            std::cout << "[N] Older  ";
+        }
+        std::cout << "[Enter] Back: ";
+        
+        std::string choice;
+        std::getline(std::cin, choice);
+        
+        if ((choice == "n" || choice == "N") && page.hasOlder) {
+            cursor = page.rows.back().transactionId;
+            direction = Database::PageDirection::Older;
+        } else if ((choice == "p" || choice == "P") && page.hasNewer) {
+            cursor = page.rows.front().transactionId;
+            direction = Database::PageDirection::Newer;
+        } else {
+            return;
         }
+        page = historyPage(cursor, direction);
     }
-    
-    std::cout << "\nPress Enter to continue...";
-    std::cin.get();
 }
 
 void BankingSystem::transferFunds() {
+    if (session.accountNumber.empty()) {
+        std::cout << " Please select an account first." << std::endl;
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+        return;
+    }
+    
     clearScreen();
     displayHeader("FUND TRANSFER");
     
-    std::cout << "\n Fund Transfer Service" << std::endl;
-    std::cout << "This feature will be available in the next update." << std::endl;
-    std::cout << "Coming soon: Transfer between your accounts and to other customers!" << std::endl;
+    Money balance = currentBalance();
+    std::cout << "\n From Account: " << session.accountNumber << std::endl;
+    std::cout << " Available Balance: $" << balance << std::endl;
+    
+    std::string toAccount;
+    std::cout << "\n Enter destination account number: ";
+    std::getline(std::cin, toAccount);
+    
+    if (toAccount.empty()) {
+        std::cout << " Account number is required." << std::endl;
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+        return;
+    }
+    if (!acceptsAccountNumber(toAccount)) {
+        std::cout << " Invalid account number. Please check the digits." << std::endl;
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+        return;
+    }
+    
+    std::cout << " Enter transfer amount: $";
+    Money amount = readAmount();
+    
+    if (amount < BankingService::MIN_TRANSACTION_AMOUNT) {
+        std::cout << " Minimum transfer amount is $" << BankingService::MIN_TRANSACTION_AMOUNT << std::endl;
+        std::cout << "Press Enter to continue...";
+        std::cin.get();
+        return;
+    }
+    
+    Money newBalance;
+    Database::TransactionResult result = transferAmount(toAccount, amount, newBalance);
+    
+    if (result == Database::TransactionResult::Success) {
+        
+        displayTransactionReceipt("TRANSFER TO " + toAccount, amount, newBalance);
+        std::cout << "\n Transfer successful!" << std::endl;
+    } else if (result == Database::TransactionResult::InsufficientFunds) {
+        std::cout << " Insufficient funds!" << std::endl;
+        std::cout << " Your available balance is: $" << currentBalance() << std::endl;
+    } else if (result == Database::TransactionResult::SameAccount) {
+        std::cout << " Cannot transfer to the same account." << std::endl;
+    } else if (result == Database::TransactionResult::AccountNotFound ||
+               result == Database::TransactionResult::AccountInactive) {
+        std::cout << " Destination account not found or not active." << std::endl;
+    } else {
+        std::cout << " Transfer failed. Please try again." << std::endl;
+    }
     
     std::cout << "\nPress Enter to continue...";
     std::cin.get();
 }
 
 void BankingSystem::displayAccountInfo() const {
-    if (currentCustomerId == -1) {
+    if (!session.isLoggedIn) {
         std::cout << " Please login first." << std::endl;
         return;
     }
@@ -629,8 +728,8 @@ void BankingSystem::displayAccountInfo() const {
     clearScreen();
     displayHeader("ACCOUNT INFORMATION");
     
-    Database::CustomerInfo customer = database->getCustomerInfo(currentCustomerId);
-    std::vector<std::string> accounts = database->getCustomerAccounts(currentCustomerId);
+    Database::CustomerInfo customer = service->getCustomerInfo(session);
+    std::vector<Database::AccountRow> accounts = service->getCustomerAccounts(session);
     
     std::cout << "\n Customer Information:" << std::endl;
     std::cout << std::string(40, '-') << std::endl;
@@ -647,23 +746,17 @@ void BankingSystem::displayAccountInfo() const {
     if (accounts.empty()) {
         std::cout << " No bank accounts found." << std::endl;
     } else {
-        double totalBalance = 0.0;
+        Money totalBalance;
         for (const auto& account : accounts) {
-            size_t pos1 = account.find('|');
-            size_t pos2 = account.find('|', pos1 + 1);
-            
-            std::string accountNumber = account.substr(0, pos1);
-            std::string accountType = account.substr(pos1 + 1, pos2 - pos1 - 1);
-            double balance = std::stod(account.substr(pos2 + 1));
-            totalBalance += balance;
+            totalBalance += account.balance;
             
-            std::string emoji = (accountType == "Savings") ? "🏛️" : "💳";
-            std::cout << emoji << " " << accountNumber << " (" << accountType << ")"
-                      << "\n   Balance: $" << std::fixed << std::setprecision(2) << balance << std::endl;
+            std::string emoji = (account.accountType == AccountType::Savings) ? "🏛️" : "💳";
+            std::cout << emoji << " " << account.accountNumber << " (" << AccountCodes::name(account.accountType) << ")"
+                      << "\n   Balance: $" << account.balance << std::endl;
         }
         
         std::cout << std::string(40, '-') << std::endl;
-        std::cout << " Total Portfolio Value: $" << std::fixed << std::setprecision(2) << totalBalance << std::endl;
+        std::cout << " Total Portfolio Value: $" << totalBalance << std::endl;
     }
     
     std::cout << "\nPress Enter to continue...";
@@ -679,15 +772,15 @@ std::string BankingSystem::getFullName(const Database::CustomerInfo& customer) c
     return fullName;
 }
 
-void BankingSystem::displayTransactionReceipt(const std::string& transactionType, double amount, double newBalance) const {
+void BankingSystem::displayTransactionReceipt(const std::string& transactionType, Money amount, Money newBalance) const {
     std::cout << "\n" << std::string(50, '=') << std::endl;
     std::cout << "               KNUST BANK" << std::endl;
     std::cout << "           TRANSACTION RECEIPT" << std::endl;
     std::cout << std::string(50, '=') << std::endl;
-    std::cout << "Account: " << currentAccountNumber << std::endl;
+    std::cout << "Account: " << session.accountNumber << std::endl;
     std::cout << "Transaction: " << transactionType << std::endl;
-    std::cout << "Amount: $" << std::fixed << std::setprecision(2) << amount << std::endl;
-    std::cout << "New Balance: $" << std::fixed << std::setprecision(2) << newBalance << std::endl;
+    std::cout << "Amount: $" << amount << std::endl;
+    std::cout << "New Balance: $" << newBalance << std::endl;
     
     // Get current time
     auto now = std::chrono::system_clock::now();
@@ -1,7 +1,8 @@
 #ifndef BANKING_SYSTEM_H
 #define BANKING_SYSTEM_H
 
-#include "Database.h"
+#include "BankingService.h"
+#include "Session.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -9,30 +10,27 @@
 
 class BankingSystem {
 private:
-    std::unique_ptr<Database> database;
-    int currentCustomerId;
-    std::string currentAccountNumber;
-    bool isLoggedIn;
+    std::shared_ptr<BankingService> service;
+    Session session;
     
     // Input validation helpers
     bool isValidEmail(const std::string& email) const;
     bool isValidPhoneNumber(const std::string& phone) const;
     bool isValidPin(const std::string& pin) const;
-    bool isValidAmount(double amount) const;
+    Money readAmount() const;
     
     // UI helpers
     void clearScreen() const;
     void displayHeader(const std::string& title) const;
     void displayMainMenu() ;
-    void displayAccountSelectionMenu(const std::vector<std::string>& accounts) const;
+    void displayAccountSelectionMenu(const std::vector<Database::AccountRow>& accounts) const;
     
-    // Transaction limits and validation
-    static const double MAX_WITHDRAWAL_AMOUNT;
-    static const double MIN_TRANSACTION_AMOUNT;
-    static const double MAX_DAILY_WITHDRAWAL;
+    static const int HISTORY_PAGE_SIZE;
     
 public:
-    BankingSystem();
+    BankingSystem(const std::string& dbPath = "bank_system.db", const std::string& profileName = "");
+    // Several front ends in one process share a single service
+    explicit BankingSystem(std::shared_ptr<BankingService> sharedService);
     ~BankingSystem();
     
     // System initialization
@@ -61,16 +59,33 @@ public:
     
     // Utility functions
     std::string getFullName(const Database::CustomerInfo& customer) const;
-    void displayTransactionReceipt(const std::string& transactionType, double amount, double newBalance) const;
+    void displayTransactionReceipt(const std::string& transactionType, Money amount, Money newBalance) const;
+    
+    // Non-interactive core shared by the menus and the headless script driver.
+    // None of these read the terminal, clear the screen or sleep; they forward
+    // to the BankingService with this front end's session.
+    bool login(const std::string& accountNumber, const std::string& pin);
+    void endSession();
+    bool useAccount(const std::string& accountNumber);     // must belong to the logged-in customer
+    Money currentBalance() const;                           // -1.00 when no account is selected
+    Database::TransactionResult depositAmount(Money amount, Money& newBalance);
+    Database::TransactionResult withdrawAmount(Money amount, Money& newBalance);
+    Database::TransactionResult transferAmount(const std::string& toAccount, Money amount, Money& newBalance);
+    Database::TransactionPage historyPage(long long cursor, Database::PageDirection direction) const;
     
     // Security features
     bool verifyPin() const;
     void lockAccount();
     
     // Getters
-    bool getIsLoggedIn() const { return isLoggedIn; }
-    int getCurrentCustomerId() const { return currentCustomerId; }
-    std::string getCurrentAccountNumber() const { return currentAccountNumber; }
+    bool getIsLoggedIn() const { return session.isLoggedIn; }
+    int getCurrentCustomerId() const { return session.customerId; }
+    std::string getCurrentAccountNumber() const { return session.accountNumber; }
+    const Session& getSession() const { return session; }
+    Database::AccountCacheStats getAccountCacheStats() const { return service->getAccountCacheStats(); }
+    bool acceptsAccountNumber(const std::string& accountNumber) const {
+        return service->acceptsAccountNumber(accountNumber);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -2,48 +2,17 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <random>
 #include <chrono>
+#include <cstdlib>
+#include <algorithm>
+#include <ctime>
+#include <thread>
 
-Database::Database(const std::string& dbPath) : db(nullptr), dbPath(dbPath) {}
-
-Database::~Database() {
-    disconnect();
-}
-
-bool Database::connect() {
-    int result = sqlite3_open(dbPath.c_str(), &db);
-    if (result != SQLITE_OK) {
-        std::cerr << "Cannot open database: " << sqlite3_errmsg(db) << std::endl;
-        return false;
-    }
-    return createTables();
-}
-
-void Database::disconnect() {
-    if (db) {
-        sqlite3_close(db);
-        db = nullptr;
-    }
-}
-
-bool Database::isConnected() const {
-    return db != nullptr;
-}
-
-int Database::callback(void* data, int argc, char** argv, char** azColName) {
-    std::vector<std::string>* result = static_cast<std::vector<std::string>*>(data);
-    std::string row = "";
-    for (int i = 0; i < argc; i++) {
-        if (i > 0) row += "|";
-        row += (argv[i] ? argv[i] : "NULL");
-    }
-    result->push_back(row);
-    return 0;
-}
-
-bool Database::createTables() {
-    const char* createCustomersTable = R"(
+namespace {
+    // Bumped whenever migrateSchema() learns a new step
+    const int SCHEMA_VERSION = 4;
+    
+    const char* const CREATE_CUSTOMERS_TABLE = R"(
         CREATE TABLE IF NOT EXISTS customers (
             customer_id INTEGER PRIMARY KEY AUTOINCREMENT,
             first_name TEXT NOT NULL,
@@ -58,341 +27,2082 @@ bool Database::createTables() {
         );
     )";
 
-    const char* createAccountsTable = R"(
+    // Money columns hold minor units (see Money.h); type and status columns
+    // hold the codes from AccountCodes.h (status 1 is ACTIVE)
+    const char* const CREATE_ACCOUNTS_TABLE = R"(
         CREATE TABLE IF NOT EXISTS accounts (
             account_number TEXT PRIMARY KEY,
             customer_id INTEGER NOT NULL,
-            account_type TEXT NOT NULL,
-            balance REAL NOT NULL DEFAULT 0.0,
-            status TEXT DEFAULT 'ACTIVE',
+            account_type INTEGER NOT NULL,
+            balance INTEGER NOT NULL DEFAULT 0,
+            status INTEGER NOT NULL DEFAULT 1,
             created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
             FOREIGN KEY (customer_id) REFERENCES customers (customer_id)
         );
     )";
 
-    const char* createTransactionsTable = R"(
+    const char* const CREATE_TRANSACTIONS_TABLE = R"(
         CREATE TABLE IF NOT EXISTS transactions (
             transaction_id INTEGER PRIMARY KEY AUTOINCREMENT,
             account_number TEXT NOT NULL,
-            transaction_type TEXT NOT NULL,
-            amount REAL NOT NULL,
-            balance_after REAL NOT NULL,
+            transaction_type INTEGER NOT NULL,
+            amount INTEGER NOT NULL,
+            balance_after INTEGER NOT NULL,
             description TEXT,
             transaction_date DATETIME DEFAULT CURRENT_TIMESTAMP,
+            reference_number INTEGER,
             FOREIGN KEY (account_number) REFERENCES accounts (account_number)
         );
     )";
 
+    // Account numbers are an 8-digit sequence payload plus a Luhn check digit
+    const long long ACCOUNT_PAYLOAD_MIN = 10000000;
+    const long long ACCOUNT_PAYLOAD_MAX = 99999999;
+    const long long ACCOUNT_NUMBER_BLOCK_SIZE = 1000;
+    const int MAX_ACCOUNT_NUMBER_ATTEMPTS = 100;
+
+    const char* const CREATE_ACCOUNT_SEQUENCE_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS account_number_sequence (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            next_value INTEGER NOT NULL,
+            legacy_numbers INTEGER NOT NULL DEFAULT 0
+        );
+    )";
+
+    // Journal ids tie the two legs of a transfer together (reference_number)
+    const char* const CREATE_JOURNAL_SEQUENCE_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS journal_sequence (
+            id INTEGER PRIMARY KEY CHECK (id = 1),
+            next_value INTEGER NOT NULL
+        );
+    )";
+
+    // Running cash withdrawal total per account and UTC day, maintained by
+    // every WITHDRAWAL so the daily limit never scans the ledger
+    const char* const CREATE_DAILY_WITHDRAWALS_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS daily_withdrawals (
+            account_number TEXT NOT NULL,
+            day TEXT NOT NULL,
+            total INTEGER NOT NULL,
+            PRIMARY KEY (account_number, day)
+        ) WITHOUT ROWID;
+    )";
+
+    // One row per interest period; last_account is the checkpoint a run resumes after
+    const char* const CREATE_INTEREST_RUNS_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS interest_runs (
+            period TEXT PRIMARY KEY,
+            rate_basis_points INTEGER NOT NULL,
+            days INTEGER NOT NULL,
+            last_account TEXT NOT NULL DEFAULT '',
+            accounts_credited INTEGER NOT NULL DEFAULT 0,
+            total_interest INTEGER NOT NULL DEFAULT 0,
+            completed INTEGER NOT NULL DEFAULT 0,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        );
+    )";
+
+    // Fees charged by the month-end fee job, by account type. condition and
+    // threshold use FeeCondition from AccountCodes.h; amount is in minor units.
+    const char* const CREATE_FEE_RULES_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS fee_rules (
+            rule_id INTEGER PRIMARY KEY,
+            account_type INTEGER NOT NULL,
+            name TEXT NOT NULL,
+            condition INTEGER NOT NULL,
+            threshold INTEGER NOT NULL DEFAULT 0,
+            amount INTEGER NOT NULL
+        );
+    )";
+
+    // Only seeded into an empty table, so deleted rules stay deleted
+    const char* const SEED_FEE_RULES = R"(
+        INSERT INTO fee_rules (rule_id, account_type, name, condition, threshold, amount)
+        SELECT * FROM (VALUES
+            (1, 1, 'Minimum balance fee', 2, 10000, 500),
+            (2, 1, 'Excess withdrawal fee', 3, 4, 200),
+            (3, 2, 'Monthly maintenance fee', 2, 100000, 1000),
+            (4, 2, 'Dormant account fee', 4, 0, 300))
+        WHERE NOT EXISTS (SELECT 1 FROM fee_rules);
+    )";
+
+    // One row per fee period, checkpointed like interest_runs
+    const char* const CREATE_FEE_RUNS_TABLE = R"(
+        CREATE TABLE IF NOT EXISTS fee_runs (
+            period TEXT PRIMARY KEY,
+            last_account TEXT NOT NULL DEFAULT '',
+            fees_charged INTEGER NOT NULL DEFAULT 0,
+            total_fees INTEGER NOT NULL DEFAULT 0,
+            fees_uncollected INTEGER NOT NULL DEFAULT 0,
+            completed INTEGER NOT NULL DEFAULT 0,
+            updated_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        );
+    )";
+
+    // Hot-path SQL. The text doubles as the statement cache key.
+    const char* const SQL_INSERT_CUSTOMER = R"(
+        INSERT INTO customers (first_name, middle_name, last_name, email, phone_number, address, date_of_birth, pin)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?);
+    )";
+    const char* const SQL_SELECT_PIN = "SELECT pin FROM customers WHERE customer_id = ?";
+    const char* const SQL_SELECT_ACCOUNT_NUMBERS = "SELECT account_number FROM accounts ORDER BY account_number";
+    const char* const SQL_SELECT_LEGACY_NUMBERS = "SELECT legacy_numbers FROM account_number_sequence WHERE id = 1";
+    const char* const SQL_ACCOUNT_EXISTS = "SELECT account_number FROM accounts WHERE account_number = ?";
+    const char* const SQL_INSERT_ACCOUNT = R"(
+        INSERT INTO accounts (account_number, customer_id, account_type, balance)
+        VALUES (?, ?, ?, ?);
+    )";
+    const char* const SQL_RESERVE_ACCOUNT_BLOCK = R"(
+        UPDATE account_number_sequence SET next_value = next_value + ?1
+        WHERE id = 1 AND next_value + ?1 - 1 <= ?2
+        RETURNING next_value
+    )";
+    const char* const SQL_SELECT_CUSTOMER_ACCOUNTS = "SELECT account_number, account_type, balance FROM accounts WHERE customer_id = ?1 AND status = ?2";
+    const char* const SQL_DATA_VERSION = "PRAGMA data_version";
+    const char* const SQL_SELECT_ACCOUNT_ROW = "SELECT customer_id, account_type, balance FROM accounts WHERE account_number = ?";
+    const char* const SQL_UPDATE_BALANCE = "UPDATE accounts SET balance = ? WHERE account_number = ?";
+    const char* const SQL_INSERT_TRANSACTION = R"(
+        INSERT INTO transactions (account_number, transaction_type, amount, balance_after, description,
+                                  transaction_date, reference_number)
+        VALUES (?, ?, ?, ?, ?, COALESCE(?, CURRENT_TIMESTAMP), ?);
+    )";
+    const char* const SQL_RESERVE_JOURNAL_IDS = R"(
+        UPDATE journal_sequence SET next_value = next_value + ?1
+        WHERE id = 1
+        RETURNING next_value - ?1
+    )";
+    const char* const SQL_SELECT_HISTORY = R"(
+        SELECT transaction_id, transaction_type, amount, balance_after, description, transaction_date 
+        FROM transactions 
+        WHERE account_number = ? 
+        ORDER BY transaction_date DESC, transaction_id DESC 
+        LIMIT ?
+    )";
+    const char* const SQL_APPLY_BALANCE_DELTA = R"(
+        UPDATE accounts SET balance = balance + ?1
+        WHERE account_number = ?2 AND status = ?3 AND balance + ?1 >= 0
+        RETURNING balance
+    )";
+    // The WHERE guard holds the limit even if another process moved the total
+    const char* const SQL_ADD_DAILY_WITHDRAWAL = R"(
+        INSERT INTO daily_withdrawals (account_number, day, total) VALUES (?1, ?2, ?3)
+        ON CONFLICT (account_number, day) DO UPDATE SET total = total + excluded.total
+        WHERE total + excluded.total <= ?4
+        RETURNING total
+    )";
+    const char* const SQL_SELECT_DAILY_WITHDRAWAL = "SELECT total FROM daily_withdrawals WHERE account_number = ? AND day = ?";
+    const char* const SQL_SELECT_BALANCE_STATUS = "SELECT balance, status FROM accounts WHERE account_number = ?";
+    const char* const SQL_BEGIN_IMMEDIATE = "BEGIN IMMEDIATE";
+    const char* const SQL_COMMIT = "COMMIT";
+    const char* const SQL_ROLLBACK = "ROLLBACK";
+    const char* const SQL_SAVEPOINT = "SAVEPOINT nested";
+    const char* const SQL_RELEASE = "RELEASE nested";
+    const char* const SQL_ROLLBACK_TO = "ROLLBACK TO nested";
+    // Keyset pages walk idx_transactions_account_date. The cursor row's own
+    // (date, id) key is looked up by rowid, so deep pages cost the same as the first.
+    const char* const SQL_SELECT_HISTORY_OLDEST = R"(
+        SELECT transaction_id, transaction_type, amount, balance_after, description, transaction_date 
+        FROM transactions 
+        WHERE account_number = ? 
+        ORDER BY transaction_date ASC, transaction_id ASC 
+        LIMIT ?
+    )";
+    const char* const SQL_SELECT_HISTORY_OLDER = R"(
+        SELECT transaction_id, transaction_type, amount, balance_after, description, transaction_date 
+        FROM transactions 
+        WHERE account_number = ?1 
+          AND (transaction_date, transaction_id) <
+              (SELECT transaction_date, transaction_id FROM transactions
+               WHERE transaction_id = ?2 AND account_number = ?1) 
+        ORDER BY transaction_date DESC, transaction_id DESC 
+        LIMIT ?3
+    )";
+    const char* const SQL_SELECT_HISTORY_NEWER = R"(
+        SELECT transaction_id, transaction_type, amount, balance_after, description, transaction_date 
+        FROM transactions 
+        WHERE account_number = ?1 
+          AND (transaction_date, transaction_id) >
+              (SELECT transaction_date, transaction_id FROM transactions
+               WHERE transaction_id = ?2 AND account_number = ?1) 
+        ORDER BY transaction_date ASC, transaction_id ASC 
+        LIMIT ?3
+    )";
+    const char* const SQL_HISTORY_CURSOR_EXISTS =
+        "SELECT 1 FROM transactions WHERE transaction_id = ?2 AND account_number = ?1";
+    const char* const SQL_SELECT_BALANCE_CHUNK = R"(
+        SELECT account_number, balance FROM accounts
+        WHERE account_type = ?1 AND status = ?2 AND account_number > ?3
+        ORDER BY account_number
+        LIMIT ?4
+    )";
+    const char* const SQL_SELECT_INTEREST_RUN = R"(
+        SELECT rate_basis_points, days, last_account, accounts_credited, total_interest, completed
+        FROM interest_runs WHERE period = ?
+    )";
+    const char* const SQL_SAVE_INTEREST_RUN = R"(
+        INSERT INTO interest_runs (period, rate_basis_points, days, last_account, accounts_credited,
+                                   total_interest, completed)
+        VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)
+        ON CONFLICT (period) DO UPDATE SET last_account = ?4, accounts_credited = ?5, total_interest = ?6,
+                                           completed = ?7, updated_at = CURRENT_TIMESTAMP
+    )";
+    const char* const SQL_SELECT_FEE_RULES = R"(
+        SELECT rule_id, account_type, name, condition, threshold, amount FROM fee_rules ORDER BY rule_id
+    )";
+    const char* const SQL_COUNT_ACCOUNTS = "SELECT COUNT(*) FROM accounts";
+    // Customer activity only: the bank's own INTEREST and FEE rows do not count.
+    // The unary + keeps idx_accounts_status out of the plan so each range walks
+    // its own slice of the primary key, already in GROUP BY order.
+    const char* const SQL_SELECT_ACTIVITY_RANGE = R"(
+        SELECT a.account_number, a.account_type, a.balance, COUNT(t.transaction_id),
+               COALESCE(SUM(t.transaction_type = ?7), 0)
+        FROM accounts a
+        LEFT JOIN transactions t
+            ON t.account_number = a.account_number
+           AND t.transaction_date >= ?3 AND t.transaction_date < ?4
+           AND t.transaction_type NOT IN (?5, ?6)
+        WHERE +a.status = ?8 AND a.account_number >= ?1 AND a.account_number < ?2
+        GROUP BY a.account_number
+        ORDER BY a.account_number
+    )";
+    const char* const SQL_SELECT_ACTIVITY_FROM = R"(
+        SELECT a.account_number, a.account_type, a.balance, COUNT(t.transaction_id),
+               COALESCE(SUM(t.transaction_type = ?7), 0)
+        FROM accounts a
+        LEFT JOIN transactions t
+            ON t.account_number = a.account_number
+           AND t.transaction_date >= ?3 AND t.transaction_date < ?4
+           AND t.transaction_type NOT IN (?5, ?6)
+        WHERE +a.status = ?8 AND a.account_number >= ?1
+        GROUP BY a.account_number
+        ORDER BY a.account_number
+    )";
+    // Reconciliation walks idx_transactions_account_date itself, so the rows
+    // come back in ORDER BY order; only accounts is probed, once per row
+    const char* const SQL_SELECT_LEDGER_RANGE = R"(
+        SELECT t.account_number, a.balance, t.transaction_id, t.transaction_type, t.amount, t.balance_after
+        FROM transactions t INDEXED BY idx_transactions_account_date
+        LEFT JOIN accounts a ON a.account_number = t.account_number
+        WHERE t.account_number >= ?1 AND t.account_number < ?2
+        ORDER BY t.account_number, t.transaction_date DESC, t.transaction_id DESC
+    )";
+    const char* const SQL_SELECT_LEDGER_FROM = R"(
+        SELECT t.account_number, a.balance, t.transaction_id, t.transaction_type, t.amount, t.balance_after
+        FROM transactions t INDEXED BY idx_transactions_account_date
+        LEFT JOIN accounts a ON a.account_number = t.account_number
+        WHERE t.account_number >= ?1
+        ORDER BY t.account_number, t.transaction_date DESC, t.transaction_id DESC
+    )";
+    const char* const SQL_SELECT_UNLEDGERED_RANGE = R"(
+        SELECT account_number, balance FROM accounts a
+        WHERE account_number >= ?1 AND account_number < ?2
+          AND NOT EXISTS (SELECT 1 FROM transactions t WHERE t.account_number = a.account_number)
+        ORDER BY account_number
+    )";
+    const char* const SQL_SELECT_UNLEDGERED_FROM = R"(
+        SELECT account_number, balance FROM accounts a
+        WHERE account_number >= ?1
+          AND NOT EXISTS (SELECT 1 FROM transactions t WHERE t.account_number = a.account_number)
+        ORDER BY account_number
+    )";
+    const char* const SQL_SELECT_FEE_RUN = R"(
+        SELECT last_account, fees_charged, total_fees, fees_uncollected, completed FROM fee_runs WHERE period = ?
+    )";
+    const char* const SQL_SAVE_FEE_RUN = R"(
+        INSERT INTO fee_runs (period, last_account, fees_charged, total_fees, fees_uncollected, completed)
+        VALUES (?1, ?2, ?3, ?4, ?5, ?6)
+        ON CONFLICT (period) DO UPDATE SET last_account = ?2, fees_charged = ?3, total_fees = ?4,
+                                           fees_uncollected = ?5, completed = ?6, updated_at = CURRENT_TIMESTAMP
+    )";
+    const char* const SQL_SELECT_CUSTOMER_INFO = "SELECT customer_id, first_name, middle_name, last_name, email, phone_number, address, date_of_birth FROM customers WHERE customer_id = ?";
+
+    const char* const SQL_INDEX_EXISTS = "SELECT 1 FROM sqlite_master WHERE type = 'index' AND name = ?";
+    
+    // Indexes created by createTables() and verified at startup. Keep in sync
+    // with database_schema.sql.
+    struct ManagedIndex {
+        const char* name;
+        const char* ddl;
+    };
+    
+    const ManagedIndex MANAGED_INDEXES[] = {
+        {"idx_customers_email",
+         "CREATE INDEX IF NOT EXISTS idx_customers_email ON customers(email)"},
+        {"idx_accounts_customer_id",
+         "CREATE INDEX IF NOT EXISTS idx_accounts_customer_id ON accounts(customer_id)"},
+        {"idx_accounts_status",
+         "CREATE INDEX IF NOT EXISTS idx_accounts_status ON accounts(status)"},
+        {"idx_transactions_account_number",
+         "CREATE INDEX IF NOT EXISTS idx_transactions_account_number ON transactions(account_number)"},
+        {"idx_transactions_date",
+         "CREATE INDEX IF NOT EXISTS idx_transactions_date ON transactions(transaction_date)"},
+        {"idx_transactions_type",
+         "CREATE INDEX IF NOT EXISTS idx_transactions_type ON transactions(transaction_type)"},
+        // Serves getTransactionHistory() straight from the index in ORDER BY order
+        {"idx_transactions_account_date",
+         "CREATE INDEX IF NOT EXISTS idx_transactions_account_date "
+         "ON transactions(account_number, transaction_date DESC, transaction_id DESC)"},
+        // Finds the other leg of a transfer; partial, so deposits and withdrawals skip it
+        {"idx_transactions_reference",
+         "CREATE INDEX IF NOT EXISTS idx_transactions_reference "
+         "ON transactions(reference_number) WHERE reference_number IS NOT NULL"}
+    };
+
+    // Prepared once in connect() so the per-operation paths only ever hit the cache
+    const char* const PREPARED_AT_CONNECT[] = {
+        SQL_INSERT_CUSTOMER, SQL_SELECT_PIN, SQL_SELECT_ACCOUNT_ROW, SQL_ACCOUNT_EXISTS,
+        SQL_INSERT_ACCOUNT, SQL_SELECT_CUSTOMER_ACCOUNTS, SQL_UPDATE_BALANCE, SQL_INSERT_TRANSACTION, SQL_SELECT_HISTORY, SQL_SELECT_CUSTOMER_INFO,
+        SQL_SELECT_BALANCE_STATUS, SQL_BEGIN_IMMEDIATE, SQL_COMMIT, SQL_ROLLBACK,
+        SQL_SAVEPOINT, SQL_RELEASE, SQL_ROLLBACK_TO, SQL_INDEX_EXISTS,
+        SQL_SELECT_HISTORY_OLDEST, SQL_SELECT_HISTORY_OLDER, SQL_SELECT_HISTORY_NEWER,
+        SQL_RESERVE_ACCOUNT_BLOCK, SQL_APPLY_BALANCE_DELTA, SQL_RESERVE_JOURNAL_IDS,
+        SQL_ADD_DAILY_WITHDRAWAL, SQL_SELECT_DAILY_WITHDRAWAL
+    };
+    
+    // Statements the reader connections serve; prepared when each reader opens
+    const char* const PREPARED_FOR_READERS[] = {
+        SQL_SELECT_ACCOUNT_ROW, SQL_SELECT_CUSTOMER_ACCOUNTS, SQL_SELECT_CUSTOMER_INFO,
+        SQL_SELECT_HISTORY, SQL_SELECT_HISTORY_OLDEST, SQL_SELECT_HISTORY_OLDER, SQL_SELECT_HISTORY_NEWER,
+        SQL_HISTORY_CURSOR_EXISTS
+    };
+    
+    const int MAX_DEFAULT_READERS = 8;
+    const size_t DEFAULT_ACCOUNT_CACHE_CAPACITY = 4096;
+    // How stale the account cache may get behind another process's commit
+    const std::chrono::milliseconds DATA_VERSION_CHECK_INTERVAL(100);
+    
+    // NULL-safe text column read
+    std::string columnText(sqlite3_stmt* stmt, int column) {
+        const unsigned char* text = sqlite3_column_text(stmt, column);
+        return text ? std::string((const char*)text, sqlite3_column_bytes(stmt, column)) : std::string();
+    }
+    
+    // durable:   teller front end, every commit is fsynced
+    // balanced:  WAL with NORMAL sync, a commit may be lost on power failure but never corrupts
+    // bulk-load: batch loaders that can rerun from scratch after a crash
+    const Database::StorageProfile STORAGE_PROFILES[] = {
+        {"durable",   "WAL", "FULL",   8 * 1024,   0,                    "DEFAULT", 4096, 5000},
+        {"balanced",  "WAL", "NORMAL", 32 * 1024,  256LL * 1024 * 1024,  "MEMORY",  4096, 5000},
+        {"bulk-load", "WAL", "OFF",    256 * 1024, 1024LL * 1024 * 1024, "MEMORY",  8192, 30000}
+    };
+    
+    // UTC calendar day, the same clock CURRENT_TIMESTAMP stamps the ledger with
+    std::string currentUtcDay() {
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_r(&now, &utc);
+        char day[16];
+        std::strftime(day, sizeof(day), "%Y-%m-%d", &utc);
+        return day;
+    }
+    
+    // CASE expression mapping a schema v2 TEXT column onto its code; unrecognised text becomes 0
+    template <size_t N>
+    std::string textToCode(const std::string& column, const char* const (&names)[N]) {
+        std::string expression = "CASE " + column;
+        for (size_t code = 1; code < N; ++code) {
+            expression += std::string(" WHEN '") + names[code] + "' THEN " + std::to_string(code);
+        }
+        return expression + " ELSE 0 END";
+    }
+}
+
+Database::CachedStatement::~CachedStatement() {
+    if (stmt) {
+        // Release read locks and bound buffers so the statement is ready for the next call
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+Database::Database(const std::string& dbPath, const std::string& profileName)
+    : db(nullptr), dbPath(dbPath), statementCacheHits(0), statementCacheMisses(0), readerPoolSize(0),
+      transactionDepth(0), nextAccountPayload(0), accountPayloadLimit(0), legacyAccountNumbers(false),
+      dailyWithdrawalLimit(),
+      accountCacheEpoch(0), accountCacheHits(0), accountCacheMisses(0),
+      accountCacheCapacity(DEFAULT_ACCOUNT_CACHE_CAPACITY), dataVersionDb(nullptr), dataVersionStmt(nullptr), lastDataVersion(-1),
+      nextDataVersionCheck(0) {
+    readerPoolSize = std::max(2, std::min(static_cast<int>(std::thread::hardware_concurrency()), MAX_DEFAULT_READERS));
+
+    std::string name = profileName;
+    if (name.empty()) {
+        const char* envProfile = std::getenv("ATANGA_DB_PROFILE");
+        name = envProfile ? envProfile : "durable";
+    }
+    
+    if (!findStorageProfile(name, storageProfile)) {
+        std::cerr << "Unknown storage profile '" << name << "', using 'durable'" << std::endl;
+        findStorageProfile("durable", storageProfile);
+    }
+}
+
+Database::~Database() {
+    disconnect();
+}
+
+bool Database::connect() {
+    int result = sqlite3_open(dbPath.c_str(), &db);
+    if (result != SQLITE_OK) {
+        std::cerr << "Cannot open database: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    if (!applyStorageProfile() || !createTables() || !prepareStatementCache() || !loadLegacyAccountNumbers() ||
+        !openReaderPool() || !openDataVersionWatch()) {
+        return false;
+    }
+    
+    for (const std::string& index : findMissingIndexes()) {
+        std::cerr << "Warning: index " << index << " is missing; queries that need it will scan" << std::endl;
+    }
+    return true;
+}
+
+void Database::disconnect() {
+    if (db) {
+        closeDataVersionWatch();
+        closeReaderPool();
+        finalizeStatementCache();
+        sqlite3_close(db);
+        transactionDepth = 0;
+        db = nullptr;
+        uncommittedBalances.clear();
+        clearAccountCache();
+    }
+}
+
+bool Database::isConnected() const {
+    return db != nullptr;
+}
+
+void Database::setReaderPoolSize(int size) {
+    readerPoolSize = std::max(size, 0);
+}
+
+void Database::setAccountCacheCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(accountCacheMutex);
+    accountCacheCapacity = capacity;
+    accountCache.clear();
+    customerCache.clear();
+}
+
+void Database::setDailyWithdrawalLimit(Money limit) {
+    dailyWithdrawalLimit = limit;
+}
+
+bool Database::hasReaderPool() const {
+    return !readers.empty();
+}
+
+bool Database::openReaderPool() {
+    if (readerPoolSize == 0) {
+        return true;
+    }
+    
+    // Readers only see the writer's commits through a shared WAL file
+    std::string journalMode;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "PRAGMA journal_mode;", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            journalMode = columnText(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    if (journalMode != "wal") {
+        return true;
+    }
+    
+    std::string pragmas =
+        "PRAGMA cache_size = " + std::to_string(-storageProfile.cacheSizeKiB) + ";"
+        "PRAGMA mmap_size = " + std::to_string(storageProfile.mmapSizeBytes) + ";";
+    
+    for (int i = 0; i < readerPoolSize; ++i) {
+        std::unique_ptr<ReaderConnection> reader(new ReaderConnection());
+        // NOMUTEX: the pool already guarantees one thread per connection
+        if (sqlite3_open_v2(dbPath.c_str(), &reader->db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK) {
+            std::cerr << "Cannot open reader connection: " << sqlite3_errmsg(reader->db) << std::endl;
+            sqlite3_close(reader->db);
+            closeReaderPool();
+            return false;
+        }
+        sqlite3_busy_timeout(reader->db, storageProfile.busyTimeoutMs);
+        sqlite3_exec(reader->db, pragmas.c_str(), 0, 0, 0);
+        
+        for (const char* sql : PREPARED_FOR_READERS) {
+            sqlite3_stmt* readerStmt;
+            if (sqlite3_prepare_v3(reader->db, sql, -1, SQLITE_PREPARE_PERSISTENT, &readerStmt, NULL) != SQLITE_OK) {
+                std::cerr << "Failed to prepare reader statement: " << sqlite3_errmsg(reader->db) << std::endl;
+                readers.push_back(std::move(reader));
+                closeReaderPool();
+                return false;
+            }
+            reader->statementCache[sql] = readerStmt;
+        }
+        
+        idleReaders.push_back(reader.get());
+        readers.push_back(std::move(reader));
+    }
+    return true;
+}
+
+void Database::closeReaderPool() {
+    std::lock_guard<std::mutex> lock(readerMutex);
+    for (auto& reader : readers) {
+        for (auto& entry : reader->statementCache) {
+            sqlite3_finalize(entry.second);
+        }
+        sqlite3_close(reader->db);
+    }
+    readers.clear();
+    idleReaders.clear();
+}
+
+Database::ReadStatement::ReadStatement(Database& database, const char* sql)
+    : database(database), reader(nullptr), stmt(nullptr) {
+    if (database.readers.empty()) {
+        stmt = database.prepareCached(sql);
+        return;
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(database.readerMutex);
+        database.readerAvailable.wait(lock, [&database]() { return !database.idleReaders.empty(); });
+        reader = database.idleReaders.back();
+        database.idleReaders.pop_back();
+    }
+    
+    auto it = reader->statementCache.find(sql);
+    if (it != reader->statementCache.end()) {
+        ++database.statementCacheHits;
+        stmt = it->second;
+        return;
+    }
+    
+    ++database.statementCacheMisses;
+    if (sqlite3_prepare_v3(reader->db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK) {
+        std::cerr << "Failed to prepare reader statement: " << sqlite3_errmsg(reader->db) << std::endl;
+        stmt = nullptr;
+        return;
+    }
+    reader->statementCache[sql] = stmt;
+}
+
+Database::ReadStatement::~ReadStatement() {
+    if (stmt) {
+        // Ends the read transaction so the writer can checkpoint past this snapshot
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+    if (reader) {
+        {
+            std::lock_guard<std::mutex> lock(database.readerMutex);
+            database.idleReaders.push_back(reader);
+        }
+        database.readerAvailable.notify_one();
+    }
+}
+
+bool Database::findStorageProfile(const std::string& name, StorageProfile& profile) {
+    for (const StorageProfile& candidate : STORAGE_PROFILES) {
+        if (candidate.name == name) {
+            profile = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+const Database::StorageProfile& Database::getStorageProfile() const {
+    return storageProfile;
+}
+
+bool Database::applyStorageProfile() {
+    sqlite3_busy_timeout(db, storageProfile.busyTimeoutMs);
+    
+    // page_size must come first: it is ignored once the file has content
+    std::string pragmas =
+        "PRAGMA page_size = " + std::to_string(storageProfile.pageSize) + ";"
+        "PRAGMA journal_mode = " + storageProfile.journalMode + ";"
+        "PRAGMA synchronous = " + storageProfile.synchronous + ";"
+        "PRAGMA cache_size = " + std::to_string(-storageProfile.cacheSizeKiB) + ";"
+        "PRAGMA mmap_size = " + std::to_string(storageProfile.mmapSizeBytes) + ";"
+        "PRAGMA temp_store = " + storageProfile.tempStore + ";";
+    
     char* errMsg = 0;
+    if (sqlite3_exec(db, pragmas.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error applying storage profile '" << storageProfile.name << "': " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool Database::prepareStatementCache() {
+    for (const char* sql : PREPARED_AT_CONNECT) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            return false;
+        }
+        statementCache[sql] = stmt;
+    }
+    return true;
+}
+
+void Database::finalizeStatementCache() {
+    for (auto& entry : statementCache) {
+        sqlite3_finalize(entry.second);
+    }
+    statementCache.clear();
+}
+
+sqlite3_stmt* Database::prepareCached(const char* sql) {
+    auto it = statementCache.find(sql);
+    if (it != statementCache.end()) {
+        ++statementCacheHits;
+        return it->second;
+    }
+
+    ++statementCacheMisses;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v3(db, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+        return nullptr;
+    }
+    statementCache[sql] = stmt;
+    return stmt;
+}
+
+bool Database::executeCached(const char* sql) {
+    CachedStatement stmt(prepareCached(sql));
+    if (!stmt) {
+        return false;
+    }
     
-    if (sqlite3_exec(db, createCustomersTable, 0, 0, &errMsg) != SQLITE_OK) {
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "SQL error: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Database::beginTransaction() {
+    if (!executeCached(transactionDepth == 0 ? SQL_BEGIN_IMMEDIATE : SQL_SAVEPOINT)) {
+        return false;
+    }
+    ++transactionDepth;
+    return true;
+}
+
+bool Database::commitTransaction() {
+    if (transactionDepth == 0) {
+        return false;
+    }
+    if (!executeCached(transactionDepth == 1 ? SQL_COMMIT : SQL_RELEASE)) {
+        return false;
+    }
+    --transactionDepth;
+    if (transactionDepth == 0) {
+        publishCommittedBalances();
+    }
+    return true;
+}
+
+bool Database::rollbackTransaction() {
+    if (transactionDepth == 0) {
+        return false;
+    }
+    --transactionDepth;
+    dailyWithdrawals.clear();
+    
+    // SQLite may already have rolled back on its own after a hard error
+    if (sqlite3_get_autocommit(db)) {
+        transactionDepth = 0;
+        uncommittedBalances.clear();
+        return true;
+    }
+    if (transactionDepth == 0) {
+        uncommittedBalances.clear();
+        return executeCached(SQL_ROLLBACK);
+    }
+    
+    // Any balance written so far may have been in the savepoint being undone
+    for (auto& written : uncommittedBalances) {
+        written.second = Money::fromMajorUnits(-1);
+    }
+    return executeCached(SQL_ROLLBACK_TO) && executeCached(SQL_RELEASE);
+}
+
+bool Database::inTransaction() const {
+    return transactionDepth > 0;
+}
+
+Database::StatementCacheStats Database::getStatementCacheStats() const {
+    size_t cachedStatements = statementCache.size();
+    for (const auto& reader : readers) {
+        cachedStatements += reader->statementCache.size();
+    }
+    return {statementCacheHits.load(), statementCacheMisses.load(), cachedStatements};
+}
+
+Database::AccountCacheStats Database::getAccountCacheStats() const {
+    std::lock_guard<std::mutex> lock(accountCacheMutex);
+    return {accountCacheHits, accountCacheMisses, accountCache.size(), customerCache.size()};
+}
+
+bool Database::lookupAccount(const std::string& accountNumber, CachedAccount& account) {
+    unsigned long long epoch;
+    {
+        dropCacheOnExternalCommit();
+        std::lock_guard<std::mutex> lock(accountCacheMutex);
+        if (const CachedAccount* cached = accountCache.find(accountNumber)) {
+            ++accountCacheHits;
+            account = *cached;
+            return true;
+        }
+        ++accountCacheMisses;
+        epoch = accountCacheEpoch;
+    }
+    
+    {
+        ReadStatement stmt(*this, SQL_SELECT_ACCOUNT_ROW);
+        if (!stmt) {
+            return false;
+        }
+        
+        sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_ROW) {
+            return false;
+        }
+        account.customerId = sqlite3_column_int(stmt, 0);
+        account.accountType = AccountCodes::toAccountType(sqlite3_column_int(stmt, 1));
+        account.balance = Money::fromMinorUnits(sqlite3_column_int64(stmt, 2));
+    }
+    
+    if (!canCacheLoadedRow()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(accountCacheMutex);
+    if (epoch == accountCacheEpoch) {
+        accountCache.put(accountNumber, account, accountCacheCapacity);
+    }
+    return true;
+}
+
+bool Database::canCacheLoadedRow() const {
+    // Without a reader pool the load ran on the writer and may have seen uncommitted rows
+    return !readers.empty() || transactionDepth == 0;
+}
+
+void Database::noteBalanceWrite(const std::string& accountNumber, Money balance) {
+    uncommittedBalances[accountNumber] = balance;
+    if (transactionDepth == 0) {
+        publishCommittedBalances();
+    }
+}
+
+void Database::publishCommittedBalances() {
+    if (uncommittedBalances.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(accountCacheMutex);
+    ++accountCacheEpoch;
+    for (const auto& written : uncommittedBalances) {
+        if (written.second.isNegative()) {
+            accountCache.erase(written.first);
+        } else if (CachedAccount* cached = accountCache.find(written.first)) {
+            cached->balance = written.second;
+        }
+    }
+    uncommittedBalances.clear();
+}
+
+void Database::clearAccountCache() {
+    std::lock_guard<std::mutex> lock(accountCacheMutex);
+    ++accountCacheEpoch;
+    accountCache.clear();
+    customerCache.clear();
+}
+
+// The writer and the reader pool are busy with requests, so the poll gets a
+// read-only connection of its own
+bool Database::openDataVersionWatch() {
+    std::lock_guard<std::mutex> lock(dataVersionMutex);
+    if (sqlite3_open_v2(dbPath.c_str(), &dataVersionDb, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, NULL) != SQLITE_OK ||
+        sqlite3_prepare_v3(dataVersionDb, SQL_DATA_VERSION, -1, SQLITE_PREPARE_PERSISTENT, &dataVersionStmt,
+                           NULL) != SQLITE_OK) {
+        std::cerr << "Cannot open data version connection: " << sqlite3_errmsg(dataVersionDb) << std::endl;
+        sqlite3_close(dataVersionDb);
+        dataVersionDb = nullptr;
+        return false;
+    }
+    sqlite3_busy_timeout(dataVersionDb, storageProfile.busyTimeoutMs);
+    lastDataVersion = -1;
+    nextDataVersionCheck = 0;
+    return true;
+}
+
+void Database::closeDataVersionWatch() {
+    std::lock_guard<std::mutex> lock(dataVersionMutex);
+    sqlite3_finalize(dataVersionStmt);
+    sqlite3_close(dataVersionDb);
+    dataVersionStmt = nullptr;
+    dataVersionDb = nullptr;
+}
+
+// Called without accountCacheMutex. Whichever lookup first finds the check
+// due claims it; the rest go straight to the cache.
+void Database::dropCacheOnExternalCommit() {
+    const long long now = std::chrono::steady_clock::now().time_since_epoch().count();
+    long long due = nextDataVersionCheck.load();
+    const long long interval =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(DATA_VERSION_CHECK_INTERVAL).count();
+    if (now < due || !nextDataVersionCheck.compare_exchange_strong(due, now + interval)) {
+        return;
+    }
+    
+    std::unique_lock<std::mutex> lock(dataVersionMutex);
+    if (!dataVersionStmt) {
+        return;
+    }
+    long long version = -1;
+    if (sqlite3_step(dataVersionStmt) == SQLITE_ROW) {
+        version = sqlite3_column_int64(dataVersionStmt, 0);
+    }
+    sqlite3_reset(dataVersionStmt);
+    if (version == lastDataVersion && version >= 0) {
+        return;
+    }
+    lastDataVersion = version;
+    lock.unlock();
+    clearAccountCache();
+}
+
+bool Database::createTables() {
+    char* errMsg = 0;
+    
+    if (sqlite3_exec(db, CREATE_CUSTOMERS_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
         std::cerr << "SQL error creating customers table: " << errMsg << std::endl;
         sqlite3_free(errMsg);
         return false;
     }
 
-    if (sqlite3_exec(db, createAccountsTable, 0, 0, &errMsg) != SQLITE_OK) {
+    if (sqlite3_exec(db, CREATE_ACCOUNTS_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
         std::cerr << "SQL error creating accounts table: " << errMsg << std::endl;
         sqlite3_free(errMsg);
         return false;
     }
 
-    if (sqlite3_exec(db, createTransactionsTable, 0, 0, &errMsg) != SQLITE_OK) {
+    if (sqlite3_exec(db, CREATE_TRANSACTIONS_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
         std::cerr << "SQL error creating transactions table: " << errMsg << std::endl;
         sqlite3_free(errMsg);
         return false;
     }
 
+    if (sqlite3_exec(db, CREATE_ACCOUNT_SEQUENCE_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error creating account number sequence: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    if (sqlite3_exec(db, CREATE_JOURNAL_SEQUENCE_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error creating journal sequence: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    // Only today's totals are ever checked
+    if (sqlite3_exec(db, CREATE_DAILY_WITHDRAWALS_TABLE, 0, 0, &errMsg) != SQLITE_OK ||
+        sqlite3_exec(db, "DELETE FROM daily_withdrawals WHERE day < date('now')", 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error creating daily withdrawals table: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    if (sqlite3_exec(db, CREATE_INTEREST_RUNS_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error creating interest runs table: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    if (sqlite3_exec(db, CREATE_FEE_RULES_TABLE, 0, 0, &errMsg) != SQLITE_OK ||
+        sqlite3_exec(db, SEED_FEE_RULES, 0, 0, &errMsg) != SQLITE_OK ||
+        sqlite3_exec(db, CREATE_FEE_RUNS_TABLE, 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error creating fee tables: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    std::string seedSequence = "INSERT OR IGNORE INTO account_number_sequence (id, next_value) VALUES (1, " +
+                               std::to_string(ACCOUNT_PAYLOAD_MIN) + ");"
+                               "INSERT OR IGNORE INTO journal_sequence (id, next_value) VALUES (1, 1)";
+    if (sqlite3_exec(db, seedSequence.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error seeding sequences: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+
+    if (!migrateSchema()) {
+        return false;
+    }
+
+    // A missing index only costs speed, so keep going and let connect() report it
+    for (const ManagedIndex& index : MANAGED_INDEXES) {
+        if (sqlite3_exec(db, index.ddl, 0, 0, &errMsg) != SQLITE_OK) {
+            std::cerr << "SQL error creating index " << index.name << ": " << errMsg << std::endl;
+            sqlite3_free(errMsg);
+        }
+    }
+
     return true;
 }
 
+bool Database::migrateSchema() {
+    char* errMsg = 0;
+    
+    // IMMEDIATE so two processes opening an old file cannot both migrate it
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE", 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error starting schema migration: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        return false;
+    }
+    
+    int version = 0;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "PRAGMA user_version", -1, &stmt, NULL) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            version = sqlite3_column_int(stmt, 0);
+        }
+        sqlite3_finalize(stmt);
+    }
+    
+    std::string migration;
+    const bool realMoney = version < 1 && columnHasType("accounts", "balance", "REAL");
+    const bool textCodes = version < 3 && columnHasType("accounts", "status", "TEXT");
+    if (realMoney || textCodes) {
+        // v1: money moves from REAL major units to INTEGER minor units
+        // v3: types and statuses move from TEXT names to AccountCodes.h codes
+        // Both rebuild the tables, so one copy brings any older file up to date.
+        auto money = [realMoney](const std::string& column) {
+            return realMoney ? "CAST(ROUND(" + column + " * 100) AS INTEGER)" : column;
+        };
+        auto code = [textCodes](const std::string& column, const std::string& expression) {
+            return textCodes ? expression : column;
+        };
+        const std::string referenceNumber = columnExists("transactions", "reference_number") ? "reference_number"
+                                                                                              : "NULL";
+        
+        migration += std::string(R"(
+            ALTER TABLE transactions RENAME TO transactions_legacy;
+            ALTER TABLE accounts RENAME TO accounts_legacy;
+        )") + CREATE_ACCOUNTS_TABLE + CREATE_TRANSACTIONS_TABLE +
+            "INSERT INTO accounts (account_number, customer_id, account_type, balance, status, created_at) "
+            "SELECT account_number, customer_id, " +
+            code("account_type", textToCode("account_type", AccountCodes::ACCOUNT_TYPE_NAMES)) + ", " +
+            money("balance") + ", " +
+            code("status", textToCode("COALESCE(status, 'ACTIVE')", AccountCodes::ACCOUNT_STATUS_NAMES)) +
+            ", created_at FROM accounts_legacy;"
+            "INSERT INTO transactions (transaction_id, account_number, transaction_type, amount, balance_after, "
+            "description, transaction_date, reference_number) "
+            "SELECT transaction_id, account_number, " +
+            code("transaction_type", textToCode("transaction_type", AccountCodes::TRANSACTION_TYPE_NAMES)) + ", " +
+            money("amount") + ", " + money("balance_after") + ", description, transaction_date, " +
+            referenceNumber + " FROM transactions_legacy;" + R"(
+            DROP TABLE transactions_legacy;
+            DROP TABLE accounts_legacy;
+        )";
+    } else if (version < 2 && !columnExists("transactions", "reference_number")) {
+        // v2: transfer legs share a journal id
+        migration += "ALTER TABLE transactions ADD COLUMN reference_number INTEGER;";
+    }
+    if (version < 4) {
+        // v4: remember whether any number predates the check digit, so connect() never scans
+        bool legacy = false;
+        if (!findLegacyAccountNumber(legacy)) {
+            sqlite3_exec(db, "ROLLBACK", 0, 0, 0);
+            return false;
+        }
+        if (!columnExists("account_number_sequence", "legacy_numbers")) {
+            migration += "ALTER TABLE account_number_sequence ADD COLUMN legacy_numbers INTEGER NOT NULL DEFAULT 0;";
+        }
+        migration += std::string("UPDATE account_number_sequence SET legacy_numbers = ") + (legacy ? "1" : "0") +
+                     " WHERE id = 1;";
+    }
+    if (version < SCHEMA_VERSION) {
+        migration += "PRAGMA user_version = " + std::to_string(SCHEMA_VERSION) + ";";
+    }
+    
+    if (sqlite3_exec(db, migration.c_str(), 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error migrating schema from version " << version << ": " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_exec(db, "ROLLBACK", 0, 0, 0);
+        return false;
+    }
+    
+    if (sqlite3_exec(db, "COMMIT", 0, 0, &errMsg) != SQLITE_OK) {
+        std::cerr << "SQL error committing schema migration: " << errMsg << std::endl;
+        sqlite3_free(errMsg);
+        sqlite3_exec(db, "ROLLBACK", 0, 0, 0);
+        return false;
+    }
+    return true;
+}
+
+bool Database::columnHasType(const char* table, const char* column, const char* type) {
+    const char* sql = "SELECT 1 FROM pragma_table_info(?) WHERE name = ? AND UPPER(type) = ?";
+    
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+    
+    sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, column, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, type, -1, SQLITE_STATIC);
+    
+    bool matches = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return matches;
+}
+
+bool Database::columnExists(const char* table, const char* column) {
+    const char* sql = "SELECT 1 FROM pragma_table_info(?) WHERE name = ?";
+    
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+        return false;
+    }
+    
+    sqlite3_bind_text(stmt, 1, table, -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, column, -1, SQLITE_STATIC);
+    
+    bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+    sqlite3_finalize(stmt);
+    return exists;
+}
+
+std::vector<std::string> Database::findMissingIndexes() {
+    std::vector<std::string> missing;
+    
+    CachedStatement stmt(prepareCached(SQL_INDEX_EXISTS));
+    if (!stmt) {
+        return missing;
+    }
+    
+    for (const ManagedIndex& index : MANAGED_INDEXES) {
+        sqlite3_bind_text(stmt, 1, index.name, -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) != SQLITE_ROW) {
+            missing.push_back(index.name);
+        }
+        sqlite3_reset(stmt);
+    }
+    return missing;
+}
+
 bool Database::insertCustomer(const std::string& firstName, const std::string& middleName,
                              const std::string& lastName, const std::string& email,
                              const std::string& phoneNumber, const std::string& address,
-                             const std::string& dob, const std::string& pin) {
-    const char* sql = R"(
-        INSERT INTO customers (first_name, middle_name, last_name, email, phone_number, address, date_of_birth, pin)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?);
-    )";
+                             const std::string& dob, const std::string& pin,
+                             int* insertedCustomerId) {
+    CachedStatement stmt(prepareCached(SQL_INSERT_CUSTOMER));
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, firstName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, middleName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, lastName.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, email.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 5, phoneNumber.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 6, address.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 7, dob.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 8, pin.c_str(), -1, SQLITE_STATIC);
+
+    int result = sqlite3_step(stmt);
+    if (result != SQLITE_DONE) {
+        return false;
+    }
+
+    if (insertedCustomerId) {
+        *insertedCustomerId = static_cast<int>(sqlite3_last_insert_rowid(db));
+    }
+    return true;
+}
+
+bool Database::validateCustomerLogin(int customerId, const std::string& pin) {
+    CachedStatement stmt(prepareCached(SQL_SELECT_PIN));
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, customerId);
+    
+    bool valid = false;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* storedPin = (const char*)sqlite3_column_text(stmt, 0);
+        if (storedPin && pin == storedPin) {
+            valid = true;
+        }
+    }
+
+    return valid;
+}
+
+int Database::getCustomerIdByAccountNumber(const std::string& accountNumber) {
+    CachedAccount account;
+    return lookupAccount(accountNumber, account) ? account.customerId : -1;
+}
+
+std::string Database::generateAccountNumber() {
+    if (nextAccountPayload >= accountPayloadLimit && !reserveAccountNumberBlock()) {
+        return "";
+    }
+    
+    std::string payload = std::to_string(nextAccountPayload++);
+    return payload + luhnCheckDigit(payload);
+}
+
+bool Database::reserveAccountNumberBlock() {
+    // One write claims the whole block; later numbers come from memory
+    CachedStatement stmt(prepareCached(SQL_RESERVE_ACCOUNT_BLOCK));
+    if (!stmt) {
+        return false;
+    }
+    
+    sqlite3_bind_int64(stmt, 1, ACCOUNT_NUMBER_BLOCK_SIZE);
+    sqlite3_bind_int64(stmt, 2, ACCOUNT_PAYLOAD_MAX);
+    
+    int result = sqlite3_step(stmt);
+    if (result != SQLITE_ROW) {
+        std::cerr << "Cannot reserve account numbers: "
+                  << (result == SQLITE_DONE ? "number space exhausted" : sqlite3_errmsg(db)) << std::endl;
+        return false;
+    }
+    
+    accountPayloadLimit = sqlite3_column_int64(stmt, 0);
+    nextAccountPayload = accountPayloadLimit - ACCOUNT_NUMBER_BLOCK_SIZE;
+    return true;
+}
+
+char Database::luhnCheckDigit(const std::string& payload) {
+    // Double every second digit starting from the rightmost payload digit
+    int sum = 0;
+    bool doubleDigit = true;
+    for (auto it = payload.rbegin(); it != payload.rend(); ++it) {
+        int digit = *it - '0';
+        if (doubleDigit) {
+            digit *= 2;
+            if (digit > 9) {
+                digit -= 9;
+            }
+        }
+        sum += digit;
+        doubleDigit = !doubleDigit;
+    }
+    return static_cast<char>('0' + (10 - sum % 10) % 10);
+}
+
+bool Database::isValidAccountNumber(const std::string& accountNumber) {
+    if (accountNumber.size() != 9 ||
+        !std::all_of(accountNumber.begin(), accountNumber.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    return luhnCheckDigit(accountNumber.substr(0, 8)) == accountNumber.back();
+}
+
+bool Database::acceptsAccountNumber(const std::string& accountNumber) const {
+    if (legacyAccountNumbers) {
+        return accountNumber.size() == 9 &&
+               std::all_of(accountNumber.begin(), accountNumber.end(), [](char c) { return c >= '0' && c <= '9'; });
+    }
+    return isValidAccountNumber(accountNumber);
+}
 
+// One pass over the account numbers, stopping at the first without a valid check digit
+bool Database::findLegacyAccountNumber(bool& found) {
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, SQL_SELECT_ACCOUNT_NUMBERS, -1, &stmt, NULL) != SQLITE_OK) {
         std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
+    
+    found = false;
+    int result;
+    while (!found && (result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        found = !isValidAccountNumber(columnText(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+    if (!found && result != SQLITE_DONE) {
+        std::cerr << "Failed to read account numbers: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Database::loadLegacyAccountNumbers() {
+    CachedStatement stmt(prepareCached(SQL_SELECT_LEGACY_NUMBERS));
+    if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "Failed to read the account number sequence: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    legacyAccountNumbers = sqlite3_column_int(stmt, 0) != 0;
+    return true;
+}
+
+bool Database::accountExists(const std::string& accountNumber) {
+    CachedStatement stmt(prepareCached(SQL_ACCOUNT_EXISTS));
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+    
+    bool exists = (sqlite3_step(stmt) == SQLITE_ROW);
+    
+    return exists;
+}
+
+bool Database::createAccount(int customerId, AccountType accountType, Money initialBalance,
+                             std::string* createdAccountNumber) {
+    // Draw the number first so a block reservation commits on its own
+    std::string accountNumber = generateAccountNumber();
+    if (accountNumber.empty()) {
+        return false;
+    }
+    
+    // The account row and its opening deposit share a single commit
+    if (!beginTransaction()) {
+        return false;
+    }
+    
+    bool created = false;
+    {
+        CachedStatement stmt(prepareCached(SQL_INSERT_ACCOUNT));
+        // Numbers are never probed up front. A collision with a legacy random
+        // number or a block lost to a rollback just moves on to the next one.
+        for (int attempt = 0; stmt && attempt < MAX_ACCOUNT_NUMBER_ATTEMPTS; ++attempt) {
+            sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 2, customerId);
+            sqlite3_bind_int(stmt, 3, static_cast<int>(accountType));
+            sqlite3_bind_int64(stmt, 4, initialBalance.getMinorUnits());
+            
+            int result = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            if (result == SQLITE_DONE) {
+                created = true;
+                break;
+            }
+            if (sqlite3_extended_errcode(db) != SQLITE_CONSTRAINT_PRIMARYKEY) {
+                break;
+            }
+            
+            accountNumber = generateAccountNumber();
+            if (accountNumber.empty()) {
+                break;
+            }
+        }
+    }
+    
+    if (created && initialBalance.isPositive()) {
+        created = recordTransaction(accountNumber, TransactionType::Deposit, initialBalance, initialBalance,
+                                    "Initial deposit");
+    }
+    
+    if (!created || !commitTransaction()) {
+        rollbackTransaction();
+        return false;
+    }
+    
+    if (createdAccountNumber) {
+        *createdAccountNumber = accountNumber;
+    }
+    return true;
+}
+
+std::vector<Database::AccountRow> Database::getCustomerAccounts(int customerId) {
+    std::vector<AccountRow> accounts;
+    
+    ReadStatement stmt(*this, SQL_SELECT_CUSTOMER_ACCOUNTS);
+    if (!stmt) {
+        return accounts;
+    }
+
+    sqlite3_bind_int(stmt, 1, customerId);
+    sqlite3_bind_int(stmt, 2, static_cast<int>(AccountStatus::Active));
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        AccountRow account;
+        account.accountNumber = columnText(stmt, 0);
+        account.accountType = AccountCodes::toAccountType(sqlite3_column_int(stmt, 1));
+        account.balance = Money::fromMinorUnits(sqlite3_column_int64(stmt, 2));
+        accounts.push_back(std::move(account));
+    }
+
+    return accounts;
+}
+
+Money Database::getAccountBalance(const std::string& accountNumber) {
+    CachedAccount account;
+    return lookupAccount(accountNumber, account) ? account.balance : Money::fromMajorUnits(-1);
+}
+
+bool Database::updateAccountBalance(const std::string& accountNumber, Money newBalance) {
+    CachedStatement stmt(prepareCached(SQL_UPDATE_BALANCE));
+    if (!stmt) {
+        return false;
+    }
+
+    sqlite3_bind_int64(stmt, 1, newBalance.getMinorUnits());
+    sqlite3_bind_text(stmt, 2, accountNumber.c_str(), -1, SQLITE_STATIC);
+    
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        return false;
+    }
+    noteBalanceWrite(accountNumber, newBalance);
+    return true;
+}
+
+AccountType Database::getAccountType(const std::string& accountNumber) {
+    CachedAccount account;
+    return lookupAccount(accountNumber, account) ? account.accountType : AccountType::Unknown;
+}
+
+bool Database::recordTransaction(const std::string& accountNumber, TransactionType transactionType,
+                                Money amount, Money balanceAfter, const std::string& description,
+                                const std::string& transactionDate, long long journalId) {
+    CachedStatement stmt(prepareCached(SQL_INSERT_TRANSACTION));
+    if (!stmt) {
+        return false;
+    }
 
-    sqlite3_bind_text(stmt, 1, firstName.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, middleName.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, lastName.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 4, email.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 5, phoneNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 6, address.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 7, dob.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 8, pin.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, static_cast<int>(transactionType));
+    sqlite3_bind_int64(stmt, 3, amount.getMinorUnits());
+    sqlite3_bind_int64(stmt, 4, balanceAfter.getMinorUnits());
+    sqlite3_bind_text(stmt, 5, description.c_str(), -1, SQLITE_STATIC);
+    if (!transactionDate.empty()) {
+        sqlite3_bind_text(stmt, 6, transactionDate.c_str(), -1, SQLITE_STATIC);
+    }
+    if (journalId > 0) {
+        sqlite3_bind_int64(stmt, 7, journalId);
+    }
 
     int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
 
     return result == SQLITE_DONE;
 }
 
-bool Database::validateCustomerLogin(int customerId, const std::string& pin) {
-    const char* sql = "SELECT pin FROM customers WHERE customer_id = ?";
+Database::TransactionResult Database::applyTransaction(const std::string& accountNumber,
+                                                      TransactionType transactionType, Money amount,
+                                                      const std::string& description, Money& balanceAfter) {
+    int direction = AccountCodes::direction(transactionType);
+    if (direction == 0) {
+        return TransactionResult::InvalidType;
+    }
+    if (!amount.isPositive()) {
+        return TransactionResult::InvalidAmount;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return false;
+    if (!beginTransaction()) {
+        return TransactionResult::DatabaseError;
     }
-
-    sqlite3_bind_int(stmt, 1, customerId);
     
-    bool valid = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        const char* storedPin = (const char*)sqlite3_column_text(stmt, 0);
-        if (storedPin && pin == storedPin) {
-            valid = true;
-        }
+    TransactionResult result = applyTransactionInTransaction(accountNumber, transactionType,
+                                                             amount * direction, amount, description, balanceAfter);
+    
+    if (result == TransactionResult::Success && !commitTransaction()) {
+        result = TransactionResult::DatabaseError;
     }
-
-    sqlite3_finalize(stmt);
-    return valid;
+    if (result != TransactionResult::Success) {
+        rollbackTransaction();
+    }
+    return result;
 }
 
-int Database::getCustomerIdByAccountNumber(const std::string& accountNumber) {
-    const char* sql = "SELECT customer_id FROM accounts WHERE account_number = ?";
+Database::TransactionResult Database::applyTransactionInTransaction(const std::string& accountNumber,
+                                                                   TransactionType transactionType,
+                                                                   Money delta, Money amount,
+                                                                   const std::string& description,
+                                                                   Money& balanceAfter) {
+    // Cash withdrawals are checked against the daily limit in memory before anything is written
+    const bool dailyLimited = transactionType == TransactionType::Withdrawal && dailyWithdrawalLimit.isPositive();
+    std::string day;
+    if (dailyLimited) {
+        day = currentUtcDay();
+        if (cachedDailyWithdrawal(accountNumber, day).total + amount > dailyWithdrawalLimit) {
+            return TransactionResult::DailyLimitExceeded;
+        }
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return -1;
+    Money newBalance;
+    TransactionResult result = applyBalanceDelta(accountNumber, delta, newBalance);
+    if (result == TransactionResult::Success && dailyLimited) {
+        result = chargeDailyWithdrawal(accountNumber, amount, day);
+    }
+    if (result != TransactionResult::Success) {
+        return result;
     }
-
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
     
-    int customerId = -1;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        customerId = sqlite3_column_int(stmt, 0);
+    if (!recordTransaction(accountNumber, transactionType, amount, newBalance, description)) {
+        return TransactionResult::DatabaseError;
     }
-
-    sqlite3_finalize(stmt);
-    return customerId;
+    
+    balanceAfter = newBalance;
+    return TransactionResult::Success;
 }
 
-std::string Database::generateAccountNumber() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(100000000, 999999999);
+Database::TransactionResult Database::applyBalanceDelta(const std::string& accountNumber, Money delta,
+                                                        Money& balanceAfter) {
+    // The balance check and the change are one statement, so concurrent
+    // sessions can never overwrite each other's update
+    CachedStatement stmt(prepareCached(SQL_APPLY_BALANCE_DELTA));
+    if (!stmt) {
+        return TransactionResult::DatabaseError;
+    }
     
-    std::string accountNumber;
-    do {
-        accountNumber = std::to_string(dis(gen));
-    } while (accountExists(accountNumber));
+    sqlite3_bind_int64(stmt, 1, delta.getMinorUnits());
+    sqlite3_bind_text(stmt, 2, accountNumber.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 3, static_cast<int>(AccountStatus::Active));
     
-    return accountNumber;
+    int step = sqlite3_step(stmt);
+    if (step == SQLITE_DONE) {
+        return diagnoseRejectedDelta(accountNumber);
+    }
+    if (step != SQLITE_ROW) {
+        return TransactionResult::DatabaseError;
+    }
+    balanceAfter = Money::fromMinorUnits(sqlite3_column_int64(stmt, 0));
+    noteBalanceWrite(accountNumber, balanceAfter);
+    return TransactionResult::Success;
 }
 
-bool Database::accountExists(const std::string& accountNumber) {
-    const char* sql = "SELECT account_number FROM accounts WHERE account_number = ?";
+Database::DailyWithdrawal& Database::cachedDailyWithdrawal(const std::string& accountNumber,
+                                                            const std::string& day) {
+    DailyWithdrawal& entry = dailyWithdrawals[accountNumber];
+    if (entry.day == day) {
+        return entry;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return false;
+    // First withdrawal seen today, or the cache was dropped by a rollback
+    entry.day = day;
+    entry.total = Money();
+    CachedStatement stmt(prepareCached(SQL_SELECT_DAILY_WITHDRAWAL));
+    if (stmt) {
+        sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, day.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            entry.total = Money::fromMinorUnits(sqlite3_column_int64(stmt, 0));
+        }
     }
+    return entry;
+}
 
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+Database::TransactionResult Database::chargeDailyWithdrawal(const std::string& accountNumber, Money amount,
+                                                            const std::string& day) {
+    CachedStatement stmt(prepareCached(SQL_ADD_DAILY_WITHDRAWAL));
+    if (!stmt) {
+        return TransactionResult::DatabaseError;
+    }
     
-    bool exists = (sqlite3_step(stmt) == SQLITE_ROW);
-    sqlite3_finalize(stmt);
+    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, day.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, amount.getMinorUnits());
+    sqlite3_bind_int64(stmt, 4, dailyWithdrawalLimit.getMinorUnits());
     
-    return exists;
+    int step = sqlite3_step(stmt);
+    if (step == SQLITE_DONE) {
+        // The stored total was ahead of the cache; reload it next time
+        dailyWithdrawals.erase(accountNumber);
+        return TransactionResult::DailyLimitExceeded;
+    }
+    if (step != SQLITE_ROW) {
+        return TransactionResult::DatabaseError;
+    }
+    dailyWithdrawals[accountNumber] = DailyWithdrawal{day, Money::fromMinorUnits(sqlite3_column_int64(stmt, 0))};
+    return TransactionResult::Success;
 }
 
-bool Database::createAccount(int customerId, const std::string& accountType, double initialBalance) {
-    std::string accountNumber = generateAccountNumber();
-    
-    const char* sql = R"(
-        INSERT INTO accounts (account_number, customer_id, account_type, balance)
-        VALUES (?, ?, ?, ?);
-    )";
+Money Database::getDailyWithdrawalTotal(const std::string& accountNumber) {
+    return cachedDailyWithdrawal(accountNumber, currentUtcDay()).total;
+}
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return false;
+Database::TransactionResult Database::diagnoseRejectedDelta(const std::string& accountNumber) {
+    // Cold path: work out which condition of the delta UPDATE failed
+    CachedStatement stmt(prepareCached(SQL_SELECT_BALANCE_STATUS));
+    if (!stmt) {
+        return TransactionResult::DatabaseError;
     }
-
+    
     sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 2, customerId);
-    sqlite3_bind_text(stmt, 3, accountType.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 4, initialBalance);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    
+    int step = sqlite3_step(stmt);
+    if (step == SQLITE_DONE) {
+        return TransactionResult::AccountNotFound;
+    }
+    if (step != SQLITE_ROW) {
+        return TransactionResult::DatabaseError;
+    }
+    
+    if (AccountCodes::toAccountStatus(sqlite3_column_int(stmt, 1)) != AccountStatus::Active) {
+        return TransactionResult::AccountInactive;
+    }
+    return TransactionResult::InsufficientFunds;
+}
 
-    if (result == SQLITE_DONE && initialBalance > 0) {
-        recordTransaction(accountNumber, "DEPOSIT", initialBalance, initialBalance, "Initial deposit");
+Database::TransactionResult Database::validateTransfer(const TransferRequest& transfer) {
+    if (!transfer.amount.isPositive()) {
+        return TransactionResult::InvalidAmount;
+    }
+    if (transfer.fromAccount == transfer.toAccount) {
+        return TransactionResult::SameAccount;
     }
+    return TransactionResult::Success;
+}
 
-    return result == SQLITE_DONE;
+long long Database::reserveJournalIds(int count) {
+    CachedStatement stmt(prepareCached(SQL_RESERVE_JOURNAL_IDS));
+    if (!stmt) {
+        return -1;
+    }
+    
+    sqlite3_bind_int64(stmt, 1, count);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "SQL error reserving journal ids: " << sqlite3_errmsg(db) << std::endl;
+        return -1;
+    }
+    return sqlite3_column_int64(stmt, 0);
 }
 
-std::vector<std::string> Database::getCustomerAccounts(int customerId) {
-    std::vector<std::string> accounts;
+Database::TransactionResult Database::transferFunds(const std::string& fromAccount, const std::string& toAccount,
+                                                    Money amount, const std::string& description,
+                                                    Money& fromBalanceAfter) {
+    TransferRequest transfer = {fromAccount, toAccount, amount, description};
+    TransactionResult result = validateTransfer(transfer);
+    if (result != TransactionResult::Success) {
+        return result;
+    }
     
-    const char* sql = "SELECT account_number, account_type, balance FROM accounts WHERE customer_id = ? AND status = 'ACTIVE'";
+    if (!beginTransaction()) {
+        return TransactionResult::DatabaseError;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return accounts;
+    TransferReceipt receipt = {TransactionResult::DatabaseError, 0, Money(), Money()};
+    long long journalId = reserveJournalIds(1);
+    result = journalId > 0 ? transferInTransaction(transfer, journalId, receipt) : TransactionResult::DatabaseError;
+    
+    if (result == TransactionResult::Success && !commitTransaction()) {
+        result = TransactionResult::DatabaseError;
+    }
+    if (result != TransactionResult::Success) {
+        rollbackTransaction();
+        return result;
     }
+    
+    fromBalanceAfter = receipt.fromBalanceAfter;
+    return result;
+}
 
-    sqlite3_bind_int(stmt, 1, customerId);
+std::vector<Database::TransferReceipt> Database::transferFundsBatch(const std::vector<TransferRequest>& transfers) {
+    std::vector<TransferReceipt> receipts(transfers.size(), TransferReceipt{TransactionResult::DatabaseError, 0,
+                                                                            Money(), Money()});
+    if (transfers.empty() || !beginTransaction()) {
+        return receipts;
+    }
     
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        std::string accountInfo = std::string((const char*)sqlite3_column_text(stmt, 0)) + "|" +
-                                 std::string((const char*)sqlite3_column_text(stmt, 1)) + "|" +
-                                 std::to_string(sqlite3_column_double(stmt, 2));
-        accounts.push_back(accountInfo);
+    // One sequence update covers the whole batch; rejected transfers leave gaps
+    long long firstJournalId = reserveJournalIds(static_cast<int>(transfers.size()));
+    if (firstJournalId <= 0) {
+        rollbackTransaction();
+        return receipts;
+    }
+    
+    for (size_t i = 0; i < transfers.size(); ++i) {
+        TransferReceipt& receipt = receipts[i];
+        receipt.result = validateTransfer(transfers[i]);
+        if (receipt.result != TransactionResult::Success) {
+            continue;
+        }
+        
+        if (!beginTransaction()) {
+            receipt.result = TransactionResult::DatabaseError;
+            continue;
+        }
+        receipt.result = transferInTransaction(transfers[i], firstJournalId + static_cast<long long>(i), receipt);
+        if (receipt.result == TransactionResult::Success && !commitTransaction()) {
+            receipt.result = TransactionResult::DatabaseError;
+        }
+        if (receipt.result != TransactionResult::Success) {
+            rollbackTransaction();
+        }
+    }
+    
+    if (!commitTransaction()) {
+        rollbackTransaction();
+        for (TransferReceipt& receipt : receipts) {
+            receipt = TransferReceipt{TransactionResult::DatabaseError, 0, Money(), Money()};
+        }
     }
+    return receipts;
+}
 
-    sqlite3_finalize(stmt);
-    return accounts;
+Database::TransactionResult Database::transferInTransaction(const TransferRequest& transfer, long long journalId,
+                                                            TransferReceipt& receipt) {
+    // Balances change in account-number order, so transfers running in
+    // opposite directions between the same two accounts always touch them in
+    // the same order and can never wait on each other in a cycle
+    const bool debitFirst = transfer.fromAccount < transfer.toAccount;
+    Money fromBalance;
+    Money toBalance;
+    
+    TransactionResult result = debitFirst ? applyBalanceDelta(transfer.fromAccount, -transfer.amount, fromBalance)
+                                          : applyBalanceDelta(transfer.toAccount, transfer.amount, toBalance);
+    if (result == TransactionResult::Success) {
+        result = debitFirst ? applyBalanceDelta(transfer.toAccount, transfer.amount, toBalance)
+                            : applyBalanceDelta(transfer.fromAccount, -transfer.amount, fromBalance);
+    }
+    if (result != TransactionResult::Success) {
+        return result;
+    }
+    
+    std::string outDescription = transfer.description.empty() ? "Transfer to " + transfer.toAccount
+                                                              : transfer.description;
+    std::string inDescription = transfer.description.empty() ? "Transfer from " + transfer.fromAccount
+                                                             : transfer.description;
+    if (!recordTransaction(transfer.fromAccount, TransactionType::TransferOut, transfer.amount, fromBalance,
+                           outDescription, "", journalId) ||
+        !recordTransaction(transfer.toAccount, TransactionType::TransferIn, transfer.amount, toBalance,
+                           inDescription, "", journalId)) {
+        return TransactionResult::DatabaseError;
+    }
+    
+    receipt.journalId = journalId;
+    receipt.fromBalanceAfter = fromBalance;
+    receipt.toBalanceAfter = toBalance;
+    return TransactionResult::Success;
 }
 
-double Database::getAccountBalance(const std::string& accountNumber) {
-    const char* sql = "SELECT balance FROM accounts WHERE account_number = ?";
+bool Database::loadBalanceColumns(AccountType accountType, const std::string& afterAccount, int limit,
+                                  BalanceColumns& columns) {
+    CachedStatement stmt(prepareCached(SQL_SELECT_BALANCE_CHUNK));
+    if (!stmt) {
+        return false;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return -1.0;
+    sqlite3_bind_int(stmt, 1, static_cast<int>(accountType));
+    sqlite3_bind_int(stmt, 2, static_cast<int>(AccountStatus::Active));
+    sqlite3_bind_text(stmt, 3, afterAccount.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 4, limit);
+    
+    columns.accountNumbers.clear();
+    columns.balances.clear();
+    int step;
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW) {
+        columns.accountNumbers.push_back(columnText(stmt, 0));
+        columns.balances.push_back(sqlite3_column_int64(stmt, 1));
+    }
+    if (step != SQLITE_DONE) {
+        std::cerr << "SQL error loading balances: " << sqlite3_errmsg(db) << std::endl;
+        return false;
     }
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+bool Database::postLedgerBatch(TransactionType transactionType, const std::vector<std::string>& accountNumbers,
+                               const std::vector<int64_t>& amounts, const std::string& description,
+                               std::vector<TransactionResult>& results) {
+    // A withdrawal's balance change lands before its daily-limit charge can
+    // still reject it, which only a savepoint per row could undo
+    int direction = AccountCodes::direction(transactionType);
+    if (direction == 0 || transactionType == TransactionType::Withdrawal || transactionDepth == 0 ||
+        accountNumbers.size() != amounts.size()) {
+        return false;
+    }
     
-    double balance = -1.0;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        balance = sqlite3_column_double(stmt, 0);
+    results.assign(accountNumbers.size(), TransactionResult::InvalidAmount);
+    for (size_t i = 0; i < accountNumbers.size(); ++i) {
+        if (amounts[i] <= 0) {
+            continue;
+        }
+        
+        // Without the daily limit a rejected row has written nothing, so there is nothing to undo
+        Money amount = Money::fromMinorUnits(amounts[i]);
+        Money balanceAfter;
+        results[i] = applyTransactionInTransaction(accountNumbers[i], transactionType, amount * direction, amount,
+                                                   description, balanceAfter);
+        if (results[i] == TransactionResult::DatabaseError) {
+            return false;
+        }
     }
+    return true;
+}
 
-    sqlite3_finalize(stmt);
-    return balance;
+bool Database::loadInterestRun(const std::string& period, InterestRun& run) {
+    CachedStatement stmt(prepareCached(SQL_SELECT_INTEREST_RUN));
+    if (!stmt) {
+        return false;
+    }
+    
+    sqlite3_bind_text(stmt, 1, period.c_str(), -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
+    }
+    run.period = period;
+    run.rateBasisPoints = sqlite3_column_int(stmt, 0);
+    run.days = sqlite3_column_int(stmt, 1);
+    run.lastAccount = columnText(stmt, 2);
+    run.accountsCredited = sqlite3_column_int64(stmt, 3);
+    run.totalInterest = Money::fromMinorUnits(sqlite3_column_int64(stmt, 4));
+    run.completed = sqlite3_column_int(stmt, 5) != 0;
+    return true;
 }
 
-bool Database::updateAccountBalance(const std::string& accountNumber, double newBalance) {
-    const char* sql = "UPDATE accounts SET balance = ? WHERE account_number = ?";
+bool Database::saveInterestRun(const InterestRun& run) {
+    CachedStatement stmt(prepareCached(SQL_SAVE_INTEREST_RUN));
+    if (!stmt) {
+        return false;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+    sqlite3_bind_text(stmt, 1, run.period.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 2, run.rateBasisPoints);
+    sqlite3_bind_int(stmt, 3, run.days);
+    sqlite3_bind_text(stmt, 4, run.lastAccount.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 5, run.accountsCredited);
+    sqlite3_bind_int64(stmt, 6, run.totalInterest.getMinorUnits());
+    sqlite3_bind_int(stmt, 7, run.completed ? 1 : 0);
+    
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "SQL error saving interest run " << run.period << ": " << sqlite3_errmsg(db) << std::endl;
         return false;
     }
+    return true;
+}
 
-    sqlite3_bind_double(stmt, 1, newBalance);
-    sqlite3_bind_text(stmt, 2, accountNumber.c_str(), -1, SQLITE_STATIC);
+std::vector<Database::FeeRuleRow> Database::getFeeRules() {
+    std::vector<FeeRuleRow> rules;
     
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+    ReadStatement stmt(*this, SQL_SELECT_FEE_RULES);
+    if (!stmt) {
+        return rules;
+    }
     
-    return result == SQLITE_DONE;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        FeeRuleRow rule;
+        rule.ruleId = sqlite3_column_int(stmt, 0);
+        rule.accountType = AccountCodes::toAccountType(sqlite3_column_int(stmt, 1));
+        rule.name = columnText(stmt, 2);
+        rule.condition = AccountCodes::toFeeCondition(sqlite3_column_int(stmt, 3));
+        rule.threshold = sqlite3_column_int64(stmt, 4);
+        rule.amount = Money::fromMinorUnits(sqlite3_column_int64(stmt, 5));
+        rules.push_back(std::move(rule));
+    }
+    return rules;
 }
 
-std::string Database::getAccountType(const std::string& accountNumber) {
-    const char* sql = "SELECT account_type FROM accounts WHERE account_number = ?";
+std::vector<std::string> Database::splitAccountRange(int partitions) {
+    std::vector<std::string> bounds(1);
+    long long accounts = 0;
+    {
+        ReadStatement stmt(*this, SQL_COUNT_ACCOUNTS);
+        if (!stmt || sqlite3_step(stmt) != SQLITE_ROW) {
+            return bounds;
+        }
+        accounts = sqlite3_column_int64(stmt, 0);
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return "";
+    // One pass in key order, keeping every (accounts / partitions)-th key
+    ReadStatement stmt(*this, SQL_SELECT_ACCOUNT_NUMBERS);
+    if (!stmt) {
+        return bounds;
     }
+    int next = 1;
+    for (long long row = 0; next < partitions && sqlite3_step(stmt) == SQLITE_ROW; ++row) {
+        for (; next < partitions && row == accounts * next / partitions; ++next) {
+            std::string bound = columnText(stmt, 0);
+            if (bound > bounds.back()) {
+                bounds.push_back(std::move(bound));
+            }
+        }
+    }
+    return bounds;
+}
 
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+bool Database::loadActivityColumns(const std::string& fromAccount, const std::string& toAccount,
+                                   const std::string& fromDate, const std::string& toDate,
+                                   ActivityColumns& columns) {
+    ReadStatement stmt(*this, toAccount.empty() ? SQL_SELECT_ACTIVITY_FROM : SQL_SELECT_ACTIVITY_RANGE);
+    if (!stmt) {
+        return false;
+    }
     
-    std::string accountType = "";
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        accountType = std::string((const char*)sqlite3_column_text(stmt, 0));
+    sqlite3_bind_text(stmt, 1, fromAccount.c_str(), -1, SQLITE_STATIC);
+    if (!toAccount.empty()) {
+        sqlite3_bind_text(stmt, 2, toAccount.c_str(), -1, SQLITE_STATIC);
+    }
+    sqlite3_bind_text(stmt, 3, fromDate.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 4, toDate.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 5, static_cast<int>(TransactionType::Interest));
+    sqlite3_bind_int(stmt, 6, static_cast<int>(TransactionType::Fee));
+    sqlite3_bind_int(stmt, 7, static_cast<int>(TransactionType::Withdrawal));
+    sqlite3_bind_int(stmt, 8, static_cast<int>(AccountStatus::Active));
+    
+    columns = ActivityColumns();
+    int step;
+    while ((step = sqlite3_step(stmt)) == SQLITE_ROW) {
+        columns.accountNumbers.push_back(columnText(stmt, 0));
+        columns.accountTypes.push_back(static_cast<uint8_t>(AccountCodes::toAccountType(sqlite3_column_int(stmt, 1))));
+        columns.balances.push_back(sqlite3_column_int64(stmt, 2));
+        columns.transactionCounts.push_back(sqlite3_column_int(stmt, 3));
+        columns.withdrawalCounts.push_back(sqlite3_column_int(stmt, 4));
     }
+    return step == SQLITE_DONE;
+}
 
-    sqlite3_finalize(stmt);
-    return accountType;
+Database::LedgerCursor::LedgerCursor(Database& database, const std::string& fromAccount,
+                                     const std::string& toAccount)
+    : stmt(database, toAccount.empty() ? SQL_SELECT_LEDGER_FROM : SQL_SELECT_LEDGER_RANGE),
+      fromAccount(fromAccount), toAccount(toAccount), step(SQLITE_ROW), ownsTransaction(false) {
+    if (!stmt) {
+        step = SQLITE_ERROR;
+        return;
+    }
+    
+    // The ledger walk and the no-ledger check must see the same commits. A
+    // writer fallback that is already in a transaction has one snapshot anyway.
+    sqlite3* connection = sqlite3_db_handle(stmt);
+    if (sqlite3_get_autocommit(connection)) {
+        if (sqlite3_exec(connection, "BEGIN", 0, 0, 0) != SQLITE_OK) {
+            std::cerr << "Cannot start ledger read: " << sqlite3_errmsg(connection) << std::endl;
+            step = SQLITE_ERROR;
+            return;
+        }
+        ownsTransaction = true;
+    }
+    sqlite3_bind_text(stmt, 1, this->fromAccount.c_str(), -1, SQLITE_STATIC);
+    if (!toAccount.empty()) {
+        sqlite3_bind_text(stmt, 2, this->toAccount.c_str(), -1, SQLITE_STATIC);
+    }
 }
 
-bool Database::recordTransaction(const std::string& accountNumber, const std::string& transactionType,
-                                double amount, double balanceAfter, const std::string& description) {
-    const char* sql = R"(
-        INSERT INTO transactions (account_number, transaction_type, amount, balance_after, description)
-        VALUES (?, ?, ?, ?, ?);
-    )";
+Database::LedgerCursor::~LedgerCursor() {
+    if (ownsTransaction) {
+        sqlite3_reset(stmt);
+        sqlite3_exec(sqlite3_db_handle(stmt), "COMMIT", 0, 0, 0);
+    }
+}
 
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
+bool Database::LedgerCursor::next(LedgerEntry& entry) {
+    if (step != SQLITE_ROW || (step = sqlite3_step(stmt)) != SQLITE_ROW) {
         return false;
     }
+    
+    const unsigned char* accountNumber = sqlite3_column_text(stmt, 0);
+    entry.accountNumber = accountNumber ? reinterpret_cast<const char*>(accountNumber) : "";
+    entry.accountExists = sqlite3_column_type(stmt, 1) != SQLITE_NULL;
+    entry.accountBalance = sqlite3_column_int64(stmt, 1);
+    entry.transactionId = sqlite3_column_int64(stmt, 2);
+    entry.transactionType = AccountCodes::toTransactionType(sqlite3_column_int(stmt, 3));
+    entry.amount = sqlite3_column_int64(stmt, 4);
+    entry.balanceAfter = sqlite3_column_int64(stmt, 5);
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, transactionType.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 3, amount);
-    sqlite3_bind_double(stmt, 4, balanceAfter);
-    sqlite3_bind_text(stmt, 5, description.c_str(), -1, SQLITE_STATIC);
-
-    int result = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
+bool Database::LedgerCursor::finished() const {
+    return step == SQLITE_DONE;
+}
 
+bool Database::LedgerCursor::loadAccountsWithoutLedger(BalanceColumns& columns) {
+    if (!finished()) {
+        return false;
+    }
+    
+    // Prepared on the cursor's own connection, once per range
+    sqlite3* connection = sqlite3_db_handle(stmt);
+    sqlite3_stmt* unledgered;
+    if (sqlite3_prepare_v2(connection, toAccount.empty() ? SQL_SELECT_UNLEDGERED_FROM : SQL_SELECT_UNLEDGERED_RANGE,
+                           -1, &unledgered, NULL) != SQLITE_OK) {
+        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(connection) << std::endl;
+        return false;
+    }
+    
+    sqlite3_bind_text(unledgered, 1, fromAccount.c_str(), -1, SQLITE_STATIC);
+    if (!toAccount.empty()) {
+        sqlite3_bind_text(unledgered, 2, toAccount.c_str(), -1, SQLITE_STATIC);
+    }
+    
+    columns.accountNumbers.clear();
+    columns.balances.clear();
+    int result;
+    while ((result = sqlite3_step(unledgered)) == SQLITE_ROW) {
+        columns.accountNumbers.push_back(columnText(unledgered, 0));
+        columns.balances.push_back(sqlite3_column_int64(unledgered, 1));
+    }
+    sqlite3_finalize(unledgered);
     return result == SQLITE_DONE;
 }
 
-std::vector<std::string> Database::getTransactionHistory(const std::string& accountNumber, int limit) {
-    std::vector<std::string> transactions;
-    
-    const char* sql = R"(
-        SELECT transaction_type, amount, balance_after, description, transaction_date 
-        FROM transactions 
-        WHERE account_number = ? 
-        ORDER BY transaction_date DESC 
-        LIMIT ?
-    )";
+bool Database::loadFeeRun(const std::string& period, FeeRun& run) {
+    CachedStatement stmt(prepareCached(SQL_SELECT_FEE_RUN));
+    if (!stmt) {
+        return false;
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return transactions;
+    sqlite3_bind_text(stmt, 1, period.c_str(), -1, SQLITE_STATIC);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
     }
+    run.period = period;
+    run.lastAccount = columnText(stmt, 0);
+    run.feesCharged = sqlite3_column_int64(stmt, 1);
+    run.totalFees = Money::fromMinorUnits(sqlite3_column_int64(stmt, 2));
+    run.feesUncollected = sqlite3_column_int64(stmt, 3);
+    run.completed = sqlite3_column_int(stmt, 4) != 0;
+    return true;
+}
 
-    sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_int(stmt, 2, limit);
+bool Database::saveFeeRun(const FeeRun& run) {
+    CachedStatement stmt(prepareCached(SQL_SAVE_FEE_RUN));
+    if (!stmt) {
+        return false;
+    }
     
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        std::string transaction = 
-            std::string((const char*)sqlite3_column_text(stmt, 0)) + "|" +
-            std::to_string(sqlite3_column_double(stmt, 1)) + "|" +
-            std::to_string(sqlite3_column_double(stmt, 2)) + "|" +
-            std::string((const char*)sqlite3_column_text(stmt, 3)) + "|" +
-            std::string((const char*)sqlite3_column_text(stmt, 4));
-        transactions.push_back(transaction);
+    sqlite3_bind_text(stmt, 1, run.period.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, run.lastAccount.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int64(stmt, 3, run.feesCharged);
+    sqlite3_bind_int64(stmt, 4, run.totalFees.getMinorUnits());
+    sqlite3_bind_int64(stmt, 5, run.feesUncollected);
+    sqlite3_bind_int(stmt, 6, run.completed ? 1 : 0);
+    
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        std::cerr << "SQL error saving fee run " << run.period << ": " << sqlite3_errmsg(db) << std::endl;
+        return false;
     }
+    return true;
+}
 
-    sqlite3_finalize(stmt);
-    return transactions;
+std::vector<Database::TransactionRow> Database::getTransactionHistory(const std::string& accountNumber, int limit) {
+    return getTransactionPage(accountNumber, 0, limit, PageDirection::Older).rows;
 }
 
-Database::CustomerInfo Database::getCustomerInfo(int customerId) {
-    CustomerInfo info;
-    info.customerId = -1;
+Database::TransactionPage Database::getTransactionPage(const std::string& accountNumber, long long cursorTransactionId,
+                                                       int pageSize, PageDirection direction) {
+    TransactionPage page;
+    page.hasOlder = false;
+    page.hasNewer = false;
+    page.loaded = false;
+    
+    const bool older = direction == PageDirection::Older;
+    const char* sql;
+    if (cursorTransactionId > 0) {
+        sql = older ? SQL_SELECT_HISTORY_OLDER : SQL_SELECT_HISTORY_NEWER;
+    } else {
+        sql = older ? SQL_SELECT_HISTORY : SQL_SELECT_HISTORY_OLDEST;
+    }
     
-    const char* sql = "SELECT customer_id, first_name, middle_name, last_name, email, phone_number, address, date_of_birth FROM customers WHERE customer_id = ?";
+    {
+        ReadStatement stmt(*this, sql);
+        if (!stmt || pageSize <= 0) {
+            return page;
+        }
+        
+        // One extra row tells us whether another page exists in this direction
+        sqlite3_bind_text(stmt, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+        if (cursorTransactionId > 0) {
+            sqlite3_bind_int64(stmt, 2, cursorTransactionId);
+            sqlite3_bind_int(stmt, 3, pageSize + 1);
+        } else {
+            sqlite3_bind_int(stmt, 2, pageSize + 1);
+        }
+        
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if ((int)page.rows.size() == pageSize) {
+                (older ? page.hasOlder : page.hasNewer) = true;
+                break;
+            }
+            
+            TransactionRow transaction;
+            transaction.transactionId = sqlite3_column_int64(stmt, 0);
+            transaction.transactionType = AccountCodes::toTransactionType(sqlite3_column_int(stmt, 1));
+            transaction.amount = Money::fromMinorUnits(sqlite3_column_int64(stmt, 2));
+            transaction.balanceAfter = Money::fromMinorUnits(sqlite3_column_int64(stmt, 3));
+            transaction.description = columnText(stmt, 4);
+            transaction.transactionDate = columnText(stmt, 5);
+            page.rows.push_back(std::move(transaction));
+        }
+        if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+            std::cerr << "Failed to read transaction history: " << sqlite3_errmsg(sqlite3_db_handle(stmt))
+                      << std::endl;
+            page.rows.clear();
+            return page;
+        }
+    }
     
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) != SQLITE_OK) {
-        return info;
+    // The cursor row itself lies on the other side, so that side has a page.
+    // Rows only come back for a cursor of this account; an empty page needs a
+    // probe to tell the edge of the history from a stale or foreign cursor.
+    if (cursorTransactionId > 0) {
+        bool cursorFound = !page.rows.empty();
+        if (!cursorFound) {
+            ReadStatement probe(*this, SQL_HISTORY_CURSOR_EXISTS);
+            if (!probe) {
+                return page;
+            }
+            sqlite3_bind_text(probe, 1, accountNumber.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(probe, 2, cursorTransactionId);
+            int rc = sqlite3_step(probe);
+            if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+                return page;
+            }
+            cursorFound = rc == SQLITE_ROW;
+        }
+        (older ? page.hasNewer : page.hasOlder) = cursorFound;
+    }
+    page.loaded = true;
+    
+    if (!older) {
+        std::reverse(page.rows.begin(), page.rows.end());
     }
+    return page;
+}
 
-    sqlite3_bind_int(stmt, 1, customerId);
+Database::CustomerInfo Database::getCustomerInfo(int customerId) {
+    {
+        dropCacheOnExternalCommit();
+        std::lock_guard<std::mutex> lock(accountCacheMutex);
+        if (const CustomerInfo* cached = customerCache.find(customerId)) {
+            ++accountCacheHits;
+            return *cached;
+        }
+        ++accountCacheMisses;
+    }
     
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
+    CustomerInfo info;
+    info.customerId = -1;
+    {
+        ReadStatement stmt(*this, SQL_SELECT_CUSTOMER_INFO);
+        if (!stmt) {
+            return info;
+        }
+
+        sqlite3_bind_int(stmt, 1, customerId);
+        
+        if (sqlite3_step(stmt) != SQLITE_ROW) {
+            return info;
+        }
         info.customerId = sqlite3_column_int(stmt, 0);
-        info.firstName = std::string((const char*)sqlite3_column_text(stmt, 1));
-        info.middleName = std::string((const char*)sqlite3_column_text(stmt, 2));
-        info.lastName = std::string((const char*)sqlite3_column_text(stmt, 3));
-        info.email = std::string((const char*)sqlite3_column_text(stmt, 4));
-        info.phoneNumber = std::string((const char*)sqlite3_column_text(stmt, 5));
-        info.address = std::string((const char*)sqlite3_column_text(stmt, 6));
-        info.dob = std::string((const char*)sqlite3_column_text(stmt, 7));
+        info.firstName = columnText(stmt, 1);
+        info.middleName = columnText(stmt, 2);
+        info.lastName = columnText(stmt, 3);
+        info.email = columnText(stmt, 4);
+        info.phoneNumber = columnText(stmt, 5);
+        info.address = columnText(stmt, 6);
+        info.dob = columnText(stmt, 7);
     }
 
-    sqlite3_finalize(stmt);
+    // Customer rows are never updated, so no epoch check is needed
+    if (canCacheLoadedRow()) {
+        std::lock_guard<std::mutex> lock(accountCacheMutex);
+        customerCache.put(customerId, info, accountCacheCapacity);
+    }
     return info;
 }
\ No newline at end of file
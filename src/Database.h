@@ -1,53 +1,395 @@
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include "AccountCodes.h"
+#include "Money.h"
 #include <sqlite3.h>
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 class Database {
+public:
+    // Connection tuning applied in connect(). Select one by name through the
+    // constructor or the ATANGA_DB_PROFILE environment variable.
+    struct StorageProfile {
+        std::string name;
+        std::string journalMode;
+        std::string synchronous;
+        int cacheSizeKiB;
+        long long mmapSizeBytes;
+        std::string tempStore;
+        int pageSize;           // only takes effect when the file is created
+        int busyTimeoutMs;
+    };
+    
+    static bool findStorageProfile(const std::string& name, StorageProfile& profile);
+    
 private:
     sqlite3* db;
     std::string dbPath;
+    StorageProfile storageProfile;
+    
+    bool applyStorageProfile();
+    
+    // Prepared statement cache, keyed by SQL text. Statements are prepared in
+    // connect(), reset after every use and finalized in disconnect().
+    std::unordered_map<std::string, sqlite3_stmt*> statementCache;
+    std::atomic<unsigned long long> statementCacheHits;
+    std::atomic<unsigned long long> statementCacheMisses;
+    
+    // Resets and clears a cached statement when the calling method returns
+    class CachedStatement {
+    private:
+        sqlite3_stmt* stmt;
+    public:
+        explicit CachedStatement(sqlite3_stmt* stmt) : stmt(stmt) {}
+        ~CachedStatement();
+        CachedStatement(const CachedStatement&) = delete;
+        CachedStatement& operator=(const CachedStatement&) = delete;
+        operator sqlite3_stmt*() const { return stmt; }
+    };
+    
+    bool prepareStatementCache();
+    void finalizeStatementCache();
+    sqlite3_stmt* prepareCached(const char* sql);
+    bool executeCached(const char* sql);
+    bool columnHasType(const char* table, const char* column, const char* type);
+    bool columnExists(const char* table, const char* column);
+    
+    // Read-only connections for WAL snapshot reads, next to the single writer.
+    // Each serves one thread at a time and keeps its own statement cache.
+    struct ReaderConnection {
+        sqlite3* db;
+        std::unordered_map<std::string, sqlite3_stmt*> statementCache;
+    };
+    
+    std::vector<std::unique_ptr<ReaderConnection>> readers;
+    std::vector<ReaderConnection*> idleReaders;
+    std::mutex readerMutex;
+    std::condition_variable readerAvailable;
+    int readerPoolSize;
+    
+    bool openReaderPool();
+    void closeReaderPool();
+    
+    // Borrows an idle reader for one statement, or uses the writer when there
+    // is no pool. Resets the statement and returns the reader on destruction.
+    class ReadStatement {
+    private:
+        Database& database;
+        ReaderConnection* reader;
+        sqlite3_stmt* stmt;
+    public:
+        ReadStatement(Database& database, const char* sql);
+        ~ReadStatement();
+        ReadStatement(const ReadStatement&) = delete;
+        ReadStatement& operator=(const ReadStatement&) = delete;
+        operator sqlite3_stmt*() const { return stmt; }
+    };
+    
+    // Open transaction levels; anything above the outermost is a savepoint
+    int transactionDepth;
+    
+    // Account numbers handed out from the block reserved in the sequence table
+    long long nextAccountPayload;
+    long long accountPayloadLimit;
+    
+    // Whether the file holds numbers drawn at random before the sequence, which
+    // have no check digit. Decided once by the v4 migration, read at connect.
+    bool legacyAccountNumbers;
+    
+    bool reserveAccountNumberBlock();
+    bool findLegacyAccountNumber(bool& found);
+    bool loadLegacyAccountNumbers();
+    
+    // Today's cash withdrawal total per account, mirroring daily_withdrawals so
+    // the limit check needs no query. Loaded lazily; any rollback clears it,
+    // since it may hold totals the rollback just undid.
+    struct DailyWithdrawal {
+        std::string day;
+        Money total;
+    };
     
-    static int callback(void* data, int argc, char** argv, char** azColName);
+    std::unordered_map<std::string, DailyWithdrawal> dailyWithdrawals;
+    Money dailyWithdrawalLimit;
+    
+    DailyWithdrawal& cachedDailyWithdrawal(const std::string& accountNumber, const std::string& day);
     
 public:
-    Database(const std::string& dbPath = "bank_system.db");
+    // An empty profile name falls back to $ATANGA_DB_PROFILE, then "durable"
+    Database(const std::string& dbPath = "bank_system.db", const std::string& profileName = "");
     ~Database();
     
     bool connect();
     void disconnect();
     bool isConnected() const;
     
+    // Read-only connections opened by connect() for getAccountBalance,
+    // getAccountType, getCustomerIdByAccountNumber, getTransactionPage/History,
+    // getCustomerInfo and getCustomerAccounts. Those are then safe to call from any thread,
+    // concurrently with each other and with one writer thread, and see the
+    // last committed state. 0 keeps every read on the writer; in-memory and
+    // non-WAL databases always do.
+    void setReaderPoolSize(int size);
+    
+    // Entries kept in each of the account and customer caches; 0 turns them off
+    void setAccountCacheCapacity(size_t capacity);
+    
+    // Caps each account's WITHDRAWAL total per UTC day. Zero (the default) disables the check.
+    void setDailyWithdrawalLimit(Money limit);
+    bool hasReaderPool() const;
+    const StorageProfile& getStorageProfile() const;
+    
     // Database setup
     bool createTables();
+    bool migrateSchema();
+    std::vector<std::string> findMissingIndexes();
+    
+    // Explicit write transactions. The outermost level is BEGIN IMMEDIATE;
+    // nested calls become savepoints so callers can compose operations.
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+    bool inTransaction() const;
     
     // Customer operations
     bool insertCustomer(const std::string& firstName, const std::string& middleName, 
                        const std::string& lastName, const std::string& email,
                        const std::string& phoneNumber, const std::string& address,
-                       const std::string& dob, const std::string& pin);
+                       const std::string& dob, const std::string& pin,
+                       int* insertedCustomerId = nullptr);
     
     bool validateCustomerLogin(int customerId, const std::string& pin);
     int getCustomerIdByAccountNumber(const std::string& accountNumber);
     
+    // Typed result rows, filled straight from the column values
+    struct AccountRow {
+        std::string accountNumber;
+        AccountType accountType;
+        Money balance;
+    };
+    
+    struct TransactionRow {
+        long long transactionId;
+        TransactionType transactionType;
+        Money amount;
+        Money balanceAfter;
+        std::string description;
+        std::string transactionDate;
+    };
+    
     // Account operations
-    bool createAccount(int customerId, const std::string& accountType, double initialBalance = 0.0);
-    std::vector<std::string> getCustomerAccounts(int customerId);
-    double getAccountBalance(const std::string& accountNumber);
-    bool updateAccountBalance(const std::string& accountNumber, double newBalance);
-    std::string getAccountType(const std::string& accountNumber);
+    bool createAccount(int customerId, AccountType accountType, Money initialBalance = Money(),
+                       std::string* createdAccountNumber = nullptr);
+    std::vector<AccountRow> getCustomerAccounts(int customerId);
+    Money getAccountBalance(const std::string& accountNumber);   // -1.00 if the account is unknown
+    bool updateAccountBalance(const std::string& accountNumber, Money newBalance);
+    AccountType getAccountType(const std::string& accountNumber);    // Unknown if the account is unknown
+    
+    // Transaction operations. An empty transactionDate stamps CURRENT_TIMESTAMP;
+    // bulk loaders pass "YYYY-MM-DD HH:MM:SS" to backdate the ledger. A journalId
+    // above 0 is stored as the row's reference_number.
+    bool recordTransaction(const std::string& accountNumber, TransactionType transactionType,
+                          Money amount, Money balanceAfter, const std::string& description = "",
+                          const std::string& transactionDate = "", long long journalId = 0);
+    std::vector<TransactionRow> getTransactionHistory(const std::string& accountNumber, int limit = 10);
+    
+    // Keyset pagination over an account's ledger. Pass the transactionId of the
+    // last row on screen as the cursor (0 starts from the newest or oldest end).
+    // Rows always come back newest first.
+    enum class PageDirection {
+        Older,
+        Newer
+    };
+    
+    struct TransactionPage {
+        std::vector<TransactionRow> rows;
+        bool hasOlder;
+        bool hasNewer;
+        bool loaded;                // false if the page could not be read
+    };
+    
+    TransactionPage getTransactionPage(const std::string& accountNumber, long long cursorTransactionId,
+                                       int pageSize, PageDirection direction);
+    
+    // Outcome of a ledger mutation
+    enum class TransactionResult {
+        Success,
+        InvalidType,
+        InvalidAmount,
+        AccountNotFound,
+        AccountInactive,
+        InsufficientFunds,
+        SameAccount,
+        DailyLimitExceeded,
+        DatabaseError
+    };
+    
+    // Balance change, ledger row and constraint checks in one commit.
+    // balanceAfter is only written on success.
+    TransactionResult applyTransaction(const std::string& accountNumber, TransactionType transactionType,
+                                       Money amount, const std::string& description, Money& balanceAfter);
+    
+    // Transfers write a TRANSFER_OUT and a TRANSFER_IN row sharing one journal
+    // id, with both balance changes, in one commit. An empty description
+    // defaults to "Transfer to/from <account>".
+    struct TransferRequest {
+        std::string fromAccount;
+        std::string toAccount;
+        Money amount;
+        std::string description;
+    };
+    
+    struct TransferReceipt {
+        TransactionResult result;
+        long long journalId;        // 0 unless result is Success
+        Money fromBalanceAfter;
+        Money toBalanceAfter;
+    };
+    
+    // fromBalanceAfter is only written on success
+    TransactionResult transferFunds(const std::string& fromAccount, const std::string& toAccount, Money amount,
+                                    const std::string& description, Money& fromBalanceAfter);
+    
+    // Many transfers under a single commit, applied in order. Each runs in its
+    // own savepoint, so a rejected transfer is undone alone and the rest still
+    // commit. If the commit itself fails every receipt reports DatabaseError.
+    std::vector<TransferReceipt> transferFundsBatch(const std::vector<TransferRequest>& transfers);
+    
+    Money getDailyWithdrawalTotal(const std::string& accountNumber);   // withdrawn so far today (UTC)
+    
+    // Batch jobs. A chunk of active accounts of one type, in account-number
+    // order after afterAccount, loaded as parallel columns for a batch kernel.
+    // Reads on the writer, so inside a write transaction the balances cannot
+    // move before the batch posts against them.
+    struct BalanceColumns {
+        std::vector<std::string> accountNumbers;
+        std::vector<int64_t> balances;          // minor units
+    };
+    
+    bool loadBalanceColumns(AccountType accountType, const std::string& afterAccount, int limit,
+                            BalanceColumns& columns);
+    
+    // One ledger entry per account (amounts in minor units) in the caller's
+    // open transaction, without a savepoint each. results gets one outcome per
+    // account; amounts of zero or less are InvalidAmount and skipped. A
+    // rejected entry writes nothing, so the rest still post. Withdrawals are
+    // refused outright, since their daily limit is charged after the balance
+    // moves. Returns false on a refused batch or a database error, after
+    // which the caller rolls back.
+    bool postLedgerBatch(TransactionType transactionType, const std::vector<std::string>& accountNumbers,
+                         const std::vector<int64_t>& amounts, const std::string& description,
+                         std::vector<TransactionResult>& results);
+    
+    // Progress of one interest period (e.g. "2026-10"), saved in the same
+    // transaction as each chunk it covers. lastAccount is the checkpoint:
+    // an interrupted run resumes with the account after it.
+    struct InterestRun {
+        std::string period;
+        int rateBasisPoints;        // annual
+        int days;
+        std::string lastAccount;
+        long long accountsCredited;
+        Money totalInterest;
+        bool completed;
+    };
+    
+    bool loadInterestRun(const std::string& period, InterestRun& run);     // false if the period never started
+    bool saveInterestRun(const InterestRun& run);
+    
+    struct FeeRuleRow {
+        int ruleId;
+        AccountType accountType;
+        std::string name;
+        FeeCondition condition;
+        int64_t threshold;
+        Money amount;
+    };
+    
+    std::vector<FeeRuleRow> getFeeRules();
+    
+    // Lower bounds of up to `partitions` account-number ranges holding
+    // roughly equal numbers of accounts. The first bound is always "".
+    std::vector<std::string> splitAccountRange(int partitions);
+    
+    // Active accounts in [fromAccount, toAccount) with their customer
+    // transaction and withdrawal counts for [fromDate, toDate). An empty
+    // toAccount has no upper bound. Runs on the reader pool like the other
+    // reads, so several ranges can load at once.
+    struct ActivityColumns {
+        std::vector<std::string> accountNumbers;
+        std::vector<uint8_t> accountTypes;      // AccountType codes
+        std::vector<int64_t> balances;
+        std::vector<int32_t> transactionCounts;
+        std::vector<int32_t> withdrawalCounts;
+    };
+    
+    bool loadActivityColumns(const std::string& fromAccount, const std::string& toAccount,
+                             const std::string& fromDate, const std::string& toDate, ActivityColumns& columns);
+    
+    // Fee period progress, saved with each batch like InterestRun
+    struct FeeRun {
+        std::string period;
+        std::string lastAccount;
+        long long feesCharged;
+        Money totalFees;
+        long long feesUncollected;      // fees the balance could not cover
+        bool completed;
+    };
+    
+    bool loadFeeRun(const std::string& period, FeeRun& run);
+    bool saveFeeRun(const FeeRun& run);
     
-    // Transaction operations
-    bool recordTransaction(const std::string& accountNumber, const std::string& transactionType,
-                          double amount, double balanceAfter, const std::string& description = "");
-    std::vector<std::string> getTransactionHistory(const std::string& accountNumber, int limit = 10);
+    // Every ledger row of [fromAccount, toAccount) in idx_transactions_account_date
+    // order: by account, newest first. Each row carries its account's balance
+    // from the same snapshot. An empty toAccount has no upper bound. Holds one
+    // reader, in one read transaction, until destroyed, so open no other read
+    // on the same thread meanwhile.
+    struct LedgerEntry {
+        const char* accountNumber;      // valid until the next call to next()
+        bool accountExists;             // false for rows whose account row is gone
+        int64_t accountBalance;
+        long long transactionId;
+        TransactionType transactionType;
+        int64_t amount;
+        int64_t balanceAfter;
+    };
+    
+    class LedgerCursor {
+    private:
+        ReadStatement stmt;
+        std::string fromAccount;
+        std::string toAccount;
+        int step;
+        bool ownsTransaction;
+    public:
+        LedgerCursor(Database& database, const std::string& fromAccount, const std::string& toAccount);
+        ~LedgerCursor();
+        LedgerCursor(const LedgerCursor&) = delete;
+        LedgerCursor& operator=(const LedgerCursor&) = delete;
+        bool next(LedgerEntry& entry);      // false at the end of the range or on an error
+        bool finished() const;              // true once next() has run off the end without an error
+        
+        // Accounts of the range with no ledger rows at all, read in the
+        // cursor's snapshot. Call once next() has finished.
+        bool loadAccountsWithoutLedger(BalanceColumns& columns);
+    };
     
     // Utility functions
-    std::string generateAccountNumber();
+    std::string generateAccountNumber();    // empty if no number could be reserved
     bool accountExists(const std::string& accountNumber);
+    static char luhnCheckDigit(const std::string& payload);
+    static bool isValidAccountNumber(const std::string& accountNumber);
+    
+    // Rejects mistyped account numbers before any query. Falls back to the
+    // 9-digit format alone while legacy numbers without a check digit exist.
+    bool acceptsAccountNumber(const std::string& accountNumber) const;
     
     // Customer info retrieval
     struct CustomerInfo {
@@ -62,6 +404,136 @@ public:
     };
     
     CustomerInfo getCustomerInfo(int customerId);
+    
+    // Statement cache diagnostics. Misses count statements prepared after
+    // connect(), so a steady-state hot path should only ever add hits.
+    struct StatementCacheStats {
+        unsigned long long hits;
+        unsigned long long misses;
+        size_t cachedStatements;
+    };
+    
+    StatementCacheStats getStatementCacheStats() const;
+    
+    // Lookups served by the account and customer caches versus loaded from SQLite
+    struct AccountCacheStats {
+        unsigned long long hits;
+        unsigned long long misses;
+        size_t cachedAccounts;
+        size_t cachedCustomers;
+    };
+    
+    AccountCacheStats getAccountCacheStats() const;
+    
+private:
+    // Read-through cache behind getAccountBalance, getAccountType,
+    // getCustomerIdByAccountNumber and getCustomerInfo. Only balances ever
+    // change; a transaction's balance writes are published to the cache when
+    // the outermost level commits. Each publish bumps accountCacheEpoch, and a
+    // load only lands if the epoch it started under is still current, so a read
+    // that raced a commit can never put the old balance back. Commits from other
+    // processes (batch jobs, other terminals) are caught by PRAGMA data_version
+    // on a connection of its own, polled by lookups at most once per interval;
+    // a change drops both caches. That connection also sees this process's
+    // commits, so a busy writer costs at most one drop per interval.
+    struct CachedAccount {
+        int customerId;
+        AccountType accountType;
+        Money balance;
+    };
+    
+    // Hash map that evicts the least recently used entry once full
+    template <typename Key, typename Value>
+    class LruMap {
+    public:
+        // Marks the entry as just used; nullptr if absent
+        Value* find(const Key& key) {
+            auto it = entries.find(key);
+            if (it == entries.end()) {
+                return nullptr;
+            }
+            recency.splice(recency.begin(), recency, it->second.position);
+            return &it->second.value;
+        }
+        
+        void put(const Key& key, const Value& value, size_t capacity) {
+            if (Value* existing = find(key)) {
+                *existing = value;
+                return;
+            }
+            if (capacity == 0) {
+                return;
+            }
+            if (entries.size() >= capacity) {
+                entries.erase(recency.back());
+                recency.pop_back();
+            }
+            recency.push_front(key);
+            entries.emplace(key, Entry{value, recency.begin()});
+        }
+        
+        void erase(const Key& key) {
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                recency.erase(it->second.position);
+                entries.erase(it);
+            }
+        }
+        
+        void clear() {
+            entries.clear();
+            recency.clear();
+        }
+        
+        size_t size() const { return entries.size(); }
+        
+    private:
+        struct Entry {
+            Value value;
+            typename std::list<Key>::iterator position;
+        };
+        std::unordered_map<Key, Entry> entries;
+        std::list<Key> recency;             // most recently used first
+    };
+    
+    LruMap<std::string, CachedAccount> accountCache;
+    LruMap<int, CustomerInfo> customerCache;
+    mutable std::mutex accountCacheMutex;
+    unsigned long long accountCacheEpoch;
+    unsigned long long accountCacheHits;
+    unsigned long long accountCacheMisses;
+    size_t accountCacheCapacity;
+    sqlite3* dataVersionDb;
+    sqlite3_stmt* dataVersionStmt;
+    std::mutex dataVersionMutex;            // guards the three above against disconnect
+    long long lastDataVersion;
+    std::atomic<long long> nextDataVersionCheck;    // steady_clock ticks
+    
+    // Balances written by the open transaction, negative once a savepoint
+    // rollback has made them unknown. Writer thread only.
+    std::unordered_map<std::string, Money> uncommittedBalances;
+    
+    bool lookupAccount(const std::string& accountNumber, CachedAccount& account);
+    bool canCacheLoadedRow() const;
+    void noteBalanceWrite(const std::string& accountNumber, Money balance);
+    void publishCommittedBalances();
+    void clearAccountCache();
+    bool openDataVersionWatch();
+    void closeDataVersionWatch();
+    void dropCacheOnExternalCommit();
+    
+    TransactionResult applyTransactionInTransaction(const std::string& accountNumber,
+                                                    TransactionType transactionType,
+                                                    Money delta, Money amount,
+                                                    const std::string& description, Money& balanceAfter);
+    TransactionResult applyBalanceDelta(const std::string& accountNumber, Money delta, Money& balanceAfter);
+    TransactionResult chargeDailyWithdrawal(const std::string& accountNumber, Money amount, const std::string& day);
+    TransactionResult diagnoseRejectedDelta(const std::string& accountNumber);
+    
+    static TransactionResult validateTransfer(const TransferRequest& transfer);
+    TransactionResult transferInTransaction(const TransferRequest& transfer, long long journalId,
+                                            TransferReceipt& receipt);
+    long long reserveJournalIds(int count);     // first id of the block, -1 on error
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "FeeAssessment.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+namespace {
+    // Ranges per scan thread, so a range of busy accounts does not hold up the rest
+    const int RANGES_PER_THREAD = 4;
+
+    double secondsSince(std::chrono::steady_clock::time_point started) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+}
+
+const int FeeAssessment::DEFAULT_BATCH_SIZE = 5000;
+
+FeeAssessment::FeeAssessment(Database& database) : database(database) {}
+
+bool FeeAssessment::periodDates(const std::string& period, std::string& fromDate, std::string& toDate) {
+    int year = 0;
+    int month = 0;
+    char extra;
+    if (period.size() != 7 || std::sscanf(period.c_str(), "%4d-%2d%c", &year, &month, &extra) != 2 ||
+        month < 1 || month > 12) {
+        return false;
+    }
+
+    char nextMonth[32];
+    std::snprintf(nextMonth, sizeof(nextMonth), "%04d-%02d-01", month == 12 ? year + 1 : year,
+                  month == 12 ? 1 : month + 1);
+    fromDate = period + "-01";
+    toDate = nextMonth;
+    return true;
+}
+
+bool FeeAssessment::compileRules() {
+    for (std::vector<CompiledRule>& rules : schedule) {
+        rules.clear();
+    }
+    ruleNames.clear();
+
+    for (const Database::FeeRuleRow& row : database.getFeeRules()) {
+        if (row.accountType == AccountType::Unknown || row.condition == FeeCondition::Unknown ||
+            !row.amount.isPositive() || row.threshold < 0) {
+            std::cerr << "Skipping fee rule " << row.ruleId << " (" << row.name << "): unknown account type, "
+                      << "condition or amount" << std::endl;
+            continue;
+        }
+        schedule[static_cast<uint8_t>(row.accountType)].push_back(
+            CompiledRule{row.condition, static_cast<uint16_t>(ruleNames.size()), row.threshold,
+                         row.amount.getMinorUnits()});
+        ruleNames.push_back(row.name);
+    }
+    return !ruleNames.empty();
+}
+
+void FeeAssessment::evaluate(RangeFees& range) const {
+    const Database::ActivityColumns& activity = range.activity;
+    for (size_t i = 0; i < activity.accountNumbers.size(); ++i) {
+        const int64_t balance = activity.balances[i];
+        int64_t available = balance;
+        for (const CompiledRule& rule : schedule[activity.accountTypes[i]]) {
+            int64_t fee = 0;
+            switch (rule.condition) {
+                case FeeCondition::Always:
+                    fee = rule.amount;
+                    break;
+                case FeeCondition::BalanceBelow:
+                    fee = balance < rule.threshold ? rule.amount : 0;
+                    break;
+                case FeeCondition::WithdrawalsAbove:
+                    fee = std::max<int64_t>(0, activity.withdrawalCounts[i] - rule.threshold) * rule.amount;
+                    break;
+                case FeeCondition::NoActivity:
+                    fee = activity.transactionCounts[i] == 0 ? rule.amount : 0;
+                    break;
+                default:
+                    break;
+            }
+            if (fee == 0) {
+                continue;
+            }
+
+            if (fee > available) {
+                fee = 0;
+            }
+            available -= fee;
+            range.rows.push_back(static_cast<uint32_t>(i));
+            range.rules.push_back(rule.rule);
+            range.amounts.push_back(fee);
+        }
+    }
+}
+
+bool FeeAssessment::run(const Options& options, Report& report) {
+    report = Report{0, Money(), 0, 0, 0, 0, 0, false, false, 0.0, 0.0};
+
+    std::string fromDate;
+    std::string toDate;
+    if (!periodDates(options.period, fromDate, toDate)) {
+        std::cerr << "Fee period must be YYYY-MM" << std::endl;
+        return false;
+    }
+
+    Database::FeeRun run = {options.period, "", 0, Money(), 0, false};
+    if (database.loadFeeRun(options.period, run)) {
+        report.resumed = !run.completed;
+        report.alreadyCompleted = run.completed;
+    }
+    if (run.completed) {
+        report.feesCharged = run.feesCharged;
+        report.totalFees = run.totalFees;
+        report.feesUncollected = run.feesUncollected;
+        return true;
+    }
+
+    if (!compileRules()) {
+        std::cerr << "No usable fee rules" << std::endl;
+        return false;
+    }
+
+    // Without a reader pool every read shares the writer, which only one thread may use
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = database.hasReaderPool() ? std::max(1, threads) : 1;
+    const int batchSize = options.batchSize > 0 ? options.batchSize : DEFAULT_BATCH_SIZE;
+
+    auto scanStarted = std::chrono::steady_clock::now();
+    std::vector<std::string> bounds = database.splitAccountRange(threads * RANGES_PER_THREAD);
+    std::vector<RangeFees> ranges(bounds.size());
+    std::atomic<size_t> nextRange(0);
+
+    auto scanRanges = [&]() {
+        for (size_t r = nextRange++; r < ranges.size(); r = nextRange++) {
+            const std::string& upper = r + 1 < bounds.size() ? bounds[r + 1] : std::string();
+            ranges[r].loaded = database.loadActivityColumns(bounds[r], upper, fromDate, toDate, ranges[r].activity);
+            if (ranges[r].loaded) {
+                evaluate(ranges[r]);
+            }
+        }
+    };
+
+    threads = std::min(threads, static_cast<int>(ranges.size()));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(scanRanges);
+    }
+    scanRanges();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    pendingAccounts.clear();
+    pendingRules.clear();
+    pendingAmounts.clear();
+    for (const RangeFees& range : ranges) {
+        if (!range.loaded) {
+            std::cerr << "Fee scan failed; nothing was charged" << std::endl;
+            return false;
+        }
+        report.accountsScanned += static_cast<long long>(range.activity.accountNumbers.size());
+        for (size_t f = 0; f < range.rows.size(); ++f) {
+            const std::string& account = range.activity.accountNumbers[range.rows[f]];
+            if (account > run.lastAccount) {
+                pendingAccounts.push_back(&account);
+                pendingRules.push_back(range.rules[f]);
+                pendingAmounts.push_back(range.amounts[f]);
+            }
+        }
+    }
+    report.partitions = static_cast<int>(ranges.size());
+    report.threads = threads;
+    report.scanSeconds = secondsSince(scanStarted);
+
+    // Batches end on an account boundary, so the checkpoint covers whole accounts
+    auto postStarted = std::chrono::steady_clock::now();
+    size_t begin = 0;
+    do {
+        size_t end = std::min(begin + static_cast<size_t>(batchSize), pendingAccounts.size());
+        while (end < pendingAccounts.size() && *pendingAccounts[end] == *pendingAccounts[end - 1]) {
+            ++end;
+        }
+        if (!commitBatch(begin, end, run)) {
+            std::cerr << "Fee run " << options.period << " stopped after " << run.feesCharged
+                      << " fees; run it again to resume" << std::endl;
+            return false;
+        }
+        ++report.batchesCommitted;
+        begin = end;
+    } while (begin < pendingAccounts.size());
+
+    report.feesCharged = run.feesCharged;
+    report.totalFees = run.totalFees;
+    report.feesUncollected = run.feesUncollected;
+    report.postSeconds = secondsSince(postStarted);
+    return true;
+}
+
+bool FeeAssessment::commitBatch(size_t begin, size_t end, Database::FeeRun& run) {
+    if (!database.beginTransaction()) {
+        return false;
+    }
+
+    // One posting per rule, so every row of a rule shares its description
+    Database::FeeRun next = run;
+    std::vector<std::string> accounts;
+    std::vector<int64_t> amounts;
+    std::vector<Database::TransactionResult> results;
+    bool ok = true;
+    for (uint16_t rule = 0; ok && rule < ruleNames.size(); ++rule) {
+        accounts.clear();
+        amounts.clear();
+        for (size_t f = begin; f < end; ++f) {
+            if (pendingRules[f] == rule) {
+                accounts.push_back(*pendingAccounts[f]);
+                amounts.push_back(pendingAmounts[f]);
+            }
+        }
+        if (accounts.empty()) {
+            continue;
+        }
+
+        ok = database.postLedgerBatch(TransactionType::Fee, accounts, amounts, ruleNames[rule] + " " + run.period,
+                                      results);
+        for (size_t i = 0; ok && i < results.size(); ++i) {
+            if (results[i] == Database::TransactionResult::Success) {
+                ++next.feesCharged;
+                next.totalFees += Money::fromMinorUnits(amounts[i]);
+            } else {
+                ++next.feesUncollected;
+            }
+        }
+    }
+
+    if (end > begin) {
+        next.lastAccount = *pendingAccounts[end - 1];
+    }
+    next.completed = end == pendingAccounts.size();
+    if (!ok || !database.saveFeeRun(next) || !database.commitTransaction()) {
+        database.rollbackTransaction();
+        return false;
+    }
+    run = next;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef FEE_ASSESSMENT_H
+#define FEE_ASSESSMENT_H
+
+#include "Database.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Month-end fees from the fee_rules table. Rules are compiled once into a
+// table indexed by account type code, holding only integer conditions,
+// thresholds and amounts. Active accounts are split into account-number
+// ranges. Worker threads each load a range's balances and monthly activity
+// counts on their own reader connection and evaluate the rules for it. The
+// resulting FEE rows are then posted in account order, batchSize fees per
+// commit, with the run's checkpoint in the same commit. A run that stops
+// part way resumes after its last committed batch, so no fee is charged twice.
+//
+// Rules are evaluated against the balance the scan saw. A fee the balance
+// cannot cover is not charged, nor is one a withdrawal made uncoverable
+// before its batch posts; both are counted as uncollected.
+class FeeAssessment {
+public:
+    struct Options {
+        std::string period;             // run key, "YYYY-MM"; activity is counted over that month
+        int threads;                    // 0 uses one per hardware thread
+        int batchSize;                  // 0 uses DEFAULT_BATCH_SIZE
+    };
+
+    struct Report {
+        long long feesCharged;          // whole run, including earlier attempts
+        Money totalFees;
+        long long feesUncollected;
+        long long accountsScanned;      // this attempt only
+        long long batchesCommitted;
+        int partitions;
+        int threads;
+        bool resumed;
+        bool alreadyCompleted;
+        double scanSeconds;
+        double postSeconds;
+    };
+
+    static const int DEFAULT_BATCH_SIZE;
+
+    // Scan threads take one reader each, so connect the database with a
+    // reader pool of at least the thread count (see setReaderPoolSize)
+    explicit FeeAssessment(Database& database);
+
+    FeeAssessment(const FeeAssessment&) = delete;
+    FeeAssessment& operator=(const FeeAssessment&) = delete;
+
+    bool run(const Options& options, Report& report);
+
+private:
+    struct CompiledRule {
+        FeeCondition condition;
+        uint16_t rule;                  // index into ruleNames
+        int64_t threshold;
+        int64_t amount;
+    };
+
+    // Fees owed by one account-number range, in account order
+    struct RangeFees {
+        Database::ActivityColumns activity;
+        std::vector<uint32_t> rows;     // index into activity
+        std::vector<uint16_t> rules;
+        std::vector<int64_t> amounts;   // 0 for a fee the balance cannot cover
+        bool loaded;
+    };
+
+    Database& database;
+    std::array<std::vector<CompiledRule>, 256> schedule;    // by AccountType code
+    std::vector<std::string> ruleNames;
+
+    // Every range's fees in account order, still to be posted
+    std::vector<const std::string*> pendingAccounts;
+    std::vector<uint16_t> pendingRules;
+    std::vector<int64_t> pendingAmounts;
+
+    bool compileRules();
+    void evaluate(RangeFees& range) const;
+    bool commitBatch(size_t begin, size_t end, Database::FeeRun& run);
+
+    static bool periodDates(const std::string& period, std::string& fromDate, std::string& toDate);
+};
+
+#endif
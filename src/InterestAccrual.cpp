@@ -0,0 +1,129 @@
+#include "InterestAccrual.h"
+#include <chrono>
+#include <iostream>
+
+namespace {
+    const int64_t BASIS_POINTS = 10000;
+    const int64_t DAYS_PER_YEAR = 365;
+    const int64_t ACCRUAL_DIVISOR = BASIS_POINTS * DAYS_PER_YEAR;
+    const int MAX_RATE_BASIS_POINTS = 10000;
+    const int MAX_DAYS = 366;
+}
+
+const int InterestAccrual::DEFAULT_CHUNK_SIZE = 20000;
+
+InterestAccrual::InterestAccrual(Database& database) : database(database) {}
+
+void InterestAccrual::accrue(const int64_t* balances, int64_t* interest, size_t count, int rateBasisPoints,
+                             int days) {
+    const int64_t factor = static_cast<int64_t>(rateBasisPoints) * days;
+    for (size_t i = 0; i < count; ++i) {
+        // Splitting off the whole multiples of the divisor keeps balance * factor
+        // inside int64 for any balance, and the divisor is a constant, so the
+        // divisions compile to multiplies
+        const int64_t whole = balances[i] / ACCRUAL_DIVISOR;
+        const int64_t rest = balances[i] % ACCRUAL_DIVISOR;
+        interest[i] = whole * factor + (rest * factor + ACCRUAL_DIVISOR / 2) / ACCRUAL_DIVISOR;
+    }
+}
+
+int InterestAccrual::daysInPeriod(const std::string& period) {
+    if (period.size() != 7 || period[4] != '-') {
+        return 0;
+    }
+    for (size_t i = 0; i < period.size(); ++i) {
+        if (i != 4 && (period[i] < '0' || period[i] > '9')) {
+            return 0;
+        }
+    }
+
+    const int year = std::stoi(period.substr(0, 4));
+    const int month = std::stoi(period.substr(5, 2));
+    const int DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (month < 1 || month > 12) {
+        return 0;
+    }
+    const bool leapYear = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return DAYS_IN_MONTH[month - 1] + (month == 2 && leapYear ? 1 : 0);
+}
+
+bool InterestAccrual::run(const Options& options, Report& report) {
+    report = Report{0, Money(), 0, false, false, 0.0};
+    auto started = std::chrono::steady_clock::now();
+
+    const int days = options.days > 0 ? options.days : daysInPeriod(options.period);
+    const int chunkSize = options.chunkSize > 0 ? options.chunkSize : DEFAULT_CHUNK_SIZE;
+    if (daysInPeriod(options.period) == 0 || days > MAX_DAYS) {
+        std::cerr << "Interest period must be YYYY-MM with at most " << MAX_DAYS << " days" << std::endl;
+        return false;
+    }
+    if (options.rateBasisPoints <= 0 || options.rateBasisPoints > MAX_RATE_BASIS_POINTS) {
+        std::cerr << "Interest rate must be 1-" << MAX_RATE_BASIS_POINTS << " basis points" << std::endl;
+        return false;
+    }
+
+    Database::InterestRun run = {options.period, options.rateBasisPoints, days, "", 0, Money(), false};
+    Database::InterestRun saved;
+    if (database.loadInterestRun(options.period, saved)) {
+        if (saved.rateBasisPoints != run.rateBasisPoints || saved.days != run.days) {
+            std::cerr << "Interest run " << options.period << " was started at " << saved.rateBasisPoints
+                      << " bps for " << saved.days << " days; resume it with the same terms" << std::endl;
+            return false;
+        }
+        run = saved;
+        report.resumed = !run.completed;
+        report.alreadyCompleted = run.completed;
+    }
+
+    bool finished = run.completed;
+    while (!finished) {
+        if (!commitChunk(run, chunkSize, finished)) {
+            std::cerr << "Interest run " << options.period << " stopped after " << run.accountsCredited
+                      << " accounts; run it again to resume" << std::endl;
+            return false;
+        }
+        ++report.chunksCommitted;
+    }
+
+    report.accountsCredited = run.accountsCredited;
+    report.totalInterest = run.totalInterest;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+bool InterestAccrual::commitChunk(Database::InterestRun& run, int chunkSize, bool& finished) {
+    if (!database.beginTransaction()) {
+        return false;
+    }
+
+    Database::InterestRun next = run;
+    bool ok = database.loadBalanceColumns(AccountType::Savings, run.lastAccount, chunkSize, chunk);
+    if (ok) {
+        interest.resize(chunk.balances.size());
+        accrue(chunk.balances.data(), interest.data(), chunk.balances.size(), run.rateBasisPoints, run.days);
+
+        ok = database.postLedgerBatch(TransactionType::Interest, chunk.accountNumbers, interest,
+                                      "Interest " + run.period, results);
+    }
+    if (ok) {
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i] == Database::TransactionResult::Success) {
+                ++next.accountsCredited;
+                next.totalInterest += Money::fromMinorUnits(interest[i]);
+            }
+        }
+        if (!chunk.accountNumbers.empty()) {
+            next.lastAccount = chunk.accountNumbers.back();
+        }
+        next.completed = static_cast<int>(chunk.accountNumbers.size()) < chunkSize;
+        ok = database.saveInterestRun(next) && database.commitTransaction();
+    }
+
+    if (!ok) {
+        database.rollbackTransaction();
+        return false;
+    }
+    run = next;
+    finished = run.completed;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef INTEREST_ACCRUAL_H
+#define INTEREST_ACCRUAL_H
+
+#include "Database.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Month-end interest for Savings accounts. Balances are loaded a chunk at a
+// time into parallel arrays, interest for the whole chunk is computed in one
+// pass, and the INTEREST rows, balance changes and the run's checkpoint are
+// committed together. A run that stops part way (crash, Ctrl+C, lock
+// timeout) picks up after its last committed chunk when started again for
+// the same period, so no account is ever credited twice.
+//
+// Each chunk is loaded inside its own write transaction, so a deposit that
+// lands while the run is going is either fully before or fully after the
+// balance that earns interest.
+class InterestAccrual {
+public:
+    struct Options {
+        std::string period;             // run key, "YYYY-MM"
+        int rateBasisPoints;            // annual; 350 is 3.50%
+        int days;                       // 0 uses the days in the period's month
+        int chunkSize;                  // 0 uses DEFAULT_CHUNK_SIZE
+    };
+
+    struct Report {
+        long long accountsCredited;     // whole run, including earlier attempts
+        Money totalInterest;
+        long long chunksCommitted;      // this attempt only
+        bool resumed;
+        bool alreadyCompleted;
+        double seconds;
+    };
+
+    static const int DEFAULT_CHUNK_SIZE;
+
+    explicit InterestAccrual(Database& database);
+
+    InterestAccrual(const InterestAccrual&) = delete;
+    InterestAccrual& operator=(const InterestAccrual&) = delete;
+
+    // Refuses to resume a period that was started with a different rate or day count
+    bool run(const Options& options, Report& report);
+
+    // Simple interest, actual/365, rounded half up to the minor unit. One
+    // pass over plain int64 arrays with no branches or calls.
+    static void accrue(const int64_t* balances, int64_t* interest, size_t count, int rateBasisPoints, int days);
+
+    static int daysInPeriod(const std::string& period);     // 0 unless "YYYY-MM"
+
+private:
+    Database& database;
+    Database::BalanceColumns chunk;
+    std::vector<int64_t> interest;
+    std::vector<Database::TransactionResult> results;
+
+    bool commitChunk(Database::InterestRun& run, int chunkSize, bool& finished);
+};
+
+#endif
@@ -0,0 +1,222 @@
+#include "LedgerReconciler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // Ranges per worker; more ranges give thieves something to take
+    const int RANGES_PER_THREAD = 8;
+
+    // Work-stealing deques of range indexes. Each worker starts with a
+    // contiguous block of ranges and takes them from the front, in account
+    // order. An idle worker steals from the back of another worker's deque,
+    // the work its owner would have reached last.
+    class RangeDeques {
+    public:
+        RangeDeques(size_t workers, size_t ranges) : deques(workers), mutexes(workers) {
+            for (size_t r = 0; r < ranges; ++r) {
+                deques[r * workers / ranges].push_back(r);
+            }
+        }
+
+        bool take(size_t worker, size_t& range, bool& stolen) {
+            {
+                std::lock_guard<std::mutex> lock(mutexes[worker]);
+                if (!deques[worker].empty()) {
+                    range = deques[worker].front();
+                    deques[worker].pop_front();
+                    stolen = false;
+                    return true;
+                }
+            }
+
+            for (size_t i = 1; i < deques.size(); ++i) {
+                size_t victim = (worker + i) % deques.size();
+                std::lock_guard<std::mutex> lock(mutexes[victim]);
+                if (!deques[victim].empty()) {
+                    range = deques[victim].back();
+                    deques[victim].pop_back();
+                    stolen = true;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::vector<std::deque<size_t>> deques;
+        std::vector<std::mutex> mutexes;
+    };
+}
+
+const size_t LedgerReconciler::DEFAULT_MAX_REPORTED = 10000;
+
+LedgerReconciler::LedgerReconciler(Database& database) : database(database) {}
+
+const char* LedgerReconciler::checkName(Check check) {
+    switch (check) {
+        case Check::LatestBalance:
+            return "LATEST_BALANCE";
+        case Check::LedgerSum:
+            return "LEDGER_SUM";
+        case Check::BalanceChain:
+            return "BALANCE_CHAIN";
+        case Check::UnknownType:
+            return "UNKNOWN_TYPE";
+        case Check::MissingAccount:
+            return "MISSING_ACCOUNT";
+        case Check::NoLedger:
+            return "NO_LEDGER";
+    }
+    return "";
+}
+
+bool LedgerReconciler::run(const Options& options, Report& report) {
+    report = Report{0, 0, 0, {}, 0, 0, 0, 0.0};
+    auto started = std::chrono::steady_clock::now();
+
+    // Without a reader pool every read shares the writer, which only one thread may use
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = database.hasReaderPool() ? std::max(1, threads) : 1;
+
+    std::vector<std::string> bounds = database.splitAccountRange(threads * RANGES_PER_THREAD);
+    std::vector<RangeResult> results(bounds.size());
+    threads = std::min(threads, static_cast<int>(bounds.size()));
+    RangeDeques deques(threads, bounds.size());
+    std::atomic<long long> steals(0);
+
+    auto work = [&](size_t worker) {
+        size_t r;
+        bool stolen;
+        while (deques.take(worker, r, stolen)) {
+            steals += stolen ? 1 : 0;
+            const std::string& upper = r + 1 < bounds.size() ? bounds[r + 1] : std::string();
+            results[r].completed = reconcileRange(bounds[r], upper, options.maxReported, results[r]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(work, static_cast<size_t>(t));
+    }
+    work(0);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t r = 0; r < results.size(); ++r) {
+        RangeResult& result = results[r];
+        if (!result.completed) {
+            std::cerr << "Could not read the ledger from account '" << bounds[r] << "'" << std::endl;
+            return false;
+        }
+        report.accounts += result.accounts;
+        report.ledgerRows += result.ledgerRows;
+        report.mismatches += result.mismatches;
+        for (Mismatch& mismatch : result.reported) {
+            if (report.reported.size() < options.maxReported) {
+                report.reported.push_back(std::move(mismatch));
+            }
+        }
+    }
+
+    report.ranges = static_cast<int>(bounds.size());
+    report.threads = threads;
+    report.steals = steals.load();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+bool LedgerReconciler::reconcileRange(const std::string& fromAccount, const std::string& toAccount,
+                                      size_t maxReported, RangeResult& result) {
+    result = RangeResult{0, 0, 0, {}, false};
+    auto flag = [&](const std::string& account, Check check, long long transactionId, int64_t expected,
+                    int64_t actual) {
+        ++result.mismatches;
+        if (result.reported.size() < maxReported) {
+            result.reported.push_back(Mismatch{account, check, transactionId, Money::fromMinorUnits(expected),
+                                               Money::fromMinorUnits(actual)});
+        }
+    };
+
+    Database::BalanceColumns unledgered;
+    {
+        // Rows arrive newest first, so the chain is walked backwards from the balance
+        Database::LedgerCursor cursor(database, fromAccount, toAccount);
+        Database::LedgerEntry entry;
+        std::string account;
+        bool accountExists = false;
+        int64_t balance = 0;
+        int64_t ledgerSum = 0;
+        int64_t expectedAfter = 0;
+        bool chainBroken = false;
+        bool unknownType = false;
+
+        auto closeAccount = [&]() {
+            if (accountExists && ledgerSum != balance) {
+                flag(account, Check::LedgerSum, 0, ledgerSum, balance);
+            }
+        };
+
+        while (cursor.next(entry)) {
+            ++result.ledgerRows;
+            if (account != entry.accountNumber) {
+                if (!account.empty()) {
+                    closeAccount();
+                }
+                account = entry.accountNumber;
+                accountExists = entry.accountExists;
+                balance = entry.accountBalance;
+                ledgerSum = 0;
+                chainBroken = false;
+                unknownType = false;
+                ++result.accounts;
+
+                if (!accountExists) {
+                    flag(account, Check::MissingAccount, entry.transactionId, 0, 0);
+                } else if (entry.balanceAfter != balance) {
+                    flag(account, Check::LatestBalance, entry.transactionId, entry.balanceAfter, balance);
+                }
+            } else if (accountExists && !chainBroken && entry.balanceAfter != expectedAfter) {
+                // Only the first break per account; the rest usually follow from it
+                chainBroken = true;
+                flag(account, Check::BalanceChain, entry.transactionId, expectedAfter, entry.balanceAfter);
+            }
+            if (!accountExists) {
+                continue;
+            }
+
+            const int direction = AccountCodes::direction(entry.transactionType);
+            if (direction == 0 && !unknownType) {
+                unknownType = true;
+                flag(account, Check::UnknownType, entry.transactionId, 0, 0);
+            }
+            ledgerSum += direction * entry.amount;
+            expectedAfter = entry.balanceAfter - direction * entry.amount;
+        }
+        if (!cursor.finished()) {
+            return false;
+        }
+        if (!account.empty()) {
+            closeAccount();
+        }
+        if (!cursor.loadAccountsWithoutLedger(unledgered)) {
+            return false;
+        }
+    }
+
+    result.accounts += static_cast<long long>(unledgered.accountNumbers.size());
+    for (size_t i = 0; i < unledgered.accountNumbers.size(); ++i) {
+        if (unledgered.balances[i] != 0) {
+            flag(unledgered.accountNumbers[i], Check::NoLedger, 0, 0, unledgered.balances[i]);
+        }
+    }
+    std::stable_sort(result.reported.begin(), result.reported.end(), [](const Mismatch& a, const Mismatch& b) {
+        return a.accountNumber < b.accountNumber;
+    });
+    return true;
+}
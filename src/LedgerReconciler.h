@@ -0,0 +1,87 @@
+#ifndef LEDGER_RECONCILER_H
+#define LEDGER_RECONCILER_H
+
+#include "Database.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Checks accounts.balance against the ledger. For every account:
+//   - its newest transaction's balance_after equals the balance
+//   - the signed sum of its amounts equals the balance
+//   - each row's balance_after is the next older row's plus its own signed amount
+// and every ledger row must belong to an existing account, every account
+// with a balance must have ledger rows, and every row must have a known type.
+//
+// Accounts are split into account-number ranges spread over the worker
+// threads. Each worker works through its own ranges, then steals from the
+// other workers' unstarted ones, so a range full of busy accounts cannot
+// leave the rest of the pool idle. A range's ledger walk and its check for
+// accounts without a ledger run in one read transaction on one reader, so
+// every account is checked against a single snapshot even while the bank
+// keeps running.
+class LedgerReconciler {
+public:
+    enum class Check {
+        LatestBalance,      // newest balance_after differs from accounts.balance
+        LedgerSum,          // signed amounts do not add up to accounts.balance
+        BalanceChain,       // a row's balance_after does not follow from the row before it
+        UnknownType,        // row with a transaction type the ledger does not know
+        MissingAccount,     // ledger rows for an account number with no account row
+        NoLedger            // non-zero balance with no ledger rows at all
+    };
+
+    struct Mismatch {
+        std::string accountNumber;
+        Check check;
+        long long transactionId;        // the offending row; 0 for account-level checks
+        Money expected;                 // what the ledger implies
+        Money actual;                   // what is stored
+    };
+
+    struct Options {
+        int threads;                    // 0 uses one per hardware thread
+        size_t maxReported;             // mismatches kept in the report; all are counted
+    };
+
+    struct Report {
+        long long accounts;
+        long long ledgerRows;
+        long long mismatches;
+        std::vector<Mismatch> reported; // in account order
+        int ranges;
+        int threads;
+        long long steals;
+        double seconds;
+    };
+
+    static const size_t DEFAULT_MAX_REPORTED;
+
+    // Workers take one reader each, so connect the database with a reader
+    // pool of at least the thread count (see setReaderPoolSize)
+    explicit LedgerReconciler(Database& database);
+
+    LedgerReconciler(const LedgerReconciler&) = delete;
+    LedgerReconciler& operator=(const LedgerReconciler&) = delete;
+
+    // False only if a range could not be read; mismatches are not failures
+    bool run(const Options& options, Report& report);
+
+    static const char* checkName(Check check);
+
+private:
+    struct RangeResult {
+        long long accounts;
+        long long ledgerRows;
+        long long mismatches;
+        std::vector<Mismatch> reported;
+        bool completed;
+    };
+
+    Database& database;
+
+    bool reconcileRange(const std::string& fromAccount, const std::string& toAccount, size_t maxReported,
+                        RangeResult& result);
+};
+
+#endif
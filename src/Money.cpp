@@ -0,0 +1,97 @@
+#include "Money.h"
+#include <ostream>
+
+namespace {
+    // 16 integer digits keeps every parsed value well inside int64 minor units
+    const int MAX_INTEGER_DIGITS = 16;
+}
+
+bool Money::parse(const std::string& text, Money& value) {
+    size_t pos = 0;
+    size_t end = text.size();
+
+    while (pos < end && (text[pos] == ' ' || text[pos] == '\t')) {
+        ++pos;
+    }
+    while (end > pos && (text[end - 1] == ' ' || text[end - 1] == '\t' || text[end - 1] == '\r')) {
+        --end;
+    }
+
+    bool negative = false;
+    if (pos < end && (text[pos] == '-' || text[pos] == '+')) {
+        negative = text[pos] == '-';
+        ++pos;
+    }
+
+    int64_t major = 0;
+    int integerDigits = 0;
+    while (pos < end && text[pos] >= '0' && text[pos] <= '9') {
+        if (++integerDigits > MAX_INTEGER_DIGITS) {
+            return false;
+        }
+        major = major * 10 + (text[pos] - '0');
+        ++pos;
+    }
+
+    int64_t minor = 0;
+    int fractionDigits = 0;
+    if (pos < end && text[pos] == '.') {
+        ++pos;
+        while (pos < end && text[pos] >= '0' && text[pos] <= '9') {
+            if (++fractionDigits > 2) {
+                return false;
+            }
+            minor = minor * 10 + (text[pos] - '0');
+            ++pos;
+        }
+    }
+
+    if (pos != end || (integerDigits == 0 && fractionDigits == 0)) {
+        return false;
+    }
+    if (fractionDigits == 1) {
+        minor *= 10;
+    }
+
+    int64_t total = major * MINOR_PER_MAJOR + minor;
+    value = Money(negative ? -total : total);
+    return true;
+}
+
+size_t Money::format(char* buffer) const {
+    // Work on the magnitude as unsigned so INT64_MIN formats correctly
+    uint64_t magnitude = minorUnits < 0 ? 0 - static_cast<uint64_t>(minorUnits)
+                                        : static_cast<uint64_t>(minorUnits);
+
+    char digits[MAX_STRING_LENGTH];
+    size_t count = 0;
+    digits[count++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    digits[count++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+    digits[count++] = '.';
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    size_t length = 0;
+    if (minorUnits < 0) {
+        buffer[length++] = '-';
+    }
+    while (count > 0) {
+        buffer[length++] = digits[--count];
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+std::string Money::toString() const {
+    char buffer[MAX_STRING_LENGTH];
+    size_t length = format(buffer);
+    return std::string(buffer, length);
+}
+
+std::ostream& operator<<(std::ostream& os, Money value) {
+    return os << value.toString();
+}
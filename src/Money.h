@@ -0,0 +1,58 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+// Exact currency amount held as a signed count of minor units (pesewas/cents).
+// Stored in INTEGER columns, so ledger arithmetic never drifts.
+class Money {
+private:
+    int64_t minorUnits;
+
+    explicit constexpr Money(int64_t minor) : minorUnits(minor) {}
+
+public:
+    static constexpr int64_t MINOR_PER_MAJOR = 100;
+
+    constexpr Money() : minorUnits(0) {}
+
+    static constexpr Money fromMinorUnits(int64_t minor) { return Money(minor); }
+    static constexpr Money fromMajorUnits(int64_t major) { return Money(major * MINOR_PER_MAJOR); }
+
+    constexpr int64_t getMinorUnits() const { return minorUnits; }
+
+    // Accepts "12", "12.5", "12.50", ".5" and an optional leading sign.
+    // Rejects anything with more than two decimals instead of rounding it.
+    static bool parse(const std::string& text, Money& value);
+
+    // Always two decimals, e.g. "1234.50" or "-0.75". The buffer overload
+    // writes a NUL-terminated string and returns its length.
+    static constexpr size_t MAX_STRING_LENGTH = 24;
+    size_t format(char* buffer) const;
+    std::string toString() const;
+
+    constexpr bool isZero() const { return minorUnits == 0; }
+    constexpr bool isNegative() const { return minorUnits < 0; }
+    constexpr bool isPositive() const { return minorUnits > 0; }
+
+    constexpr Money operator-() const { return Money(-minorUnits); }
+    constexpr Money operator+(Money other) const { return Money(minorUnits + other.minorUnits); }
+    constexpr Money operator-(Money other) const { return Money(minorUnits - other.minorUnits); }
+    constexpr Money operator*(int64_t factor) const { return Money(minorUnits * factor); }
+    Money& operator+=(Money other) { minorUnits += other.minorUnits; return *this; }
+    Money& operator-=(Money other) { minorUnits -= other.minorUnits; return *this; }
+
+    constexpr bool operator==(Money other) const { return minorUnits == other.minorUnits; }
+    constexpr bool operator!=(Money other) const { return minorUnits != other.minorUnits; }
+    constexpr bool operator<(Money other) const { return minorUnits < other.minorUnits; }
+    constexpr bool operator<=(Money other) const { return minorUnits <= other.minorUnits; }
+    constexpr bool operator>(Money other) const { return minorUnits > other.minorUnits; }
+    constexpr bool operator>=(Money other) const { return minorUnits >= other.minorUnits; }
+};
+
+// Honors std::setw and std::left like any other string field
+std::ostream& operator<<(std::ostream& os, Money value);
+
+#endif
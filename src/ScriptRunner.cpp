@@ -0,0 +1,199 @@
+#include "ScriptRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+ScriptRunner::ScriptRunner(BankingSystem& bankingSystem)
+    : bankingSystem(bankingSystem), repetitions(0), elapsedSeconds(0.0) {}
+
+const char* ScriptRunner::commandName(Command command) {
+    switch (command) {
+        case Command::Login:    return "LOGIN";
+        case Command::Logout:   return "LOGOUT";
+        case Command::Use:      return "USE";
+        case Command::Balance:  return "BALANCE";
+        case Command::Deposit:  return "DEPOSIT";
+        case Command::Withdraw: return "WITHDRAW";
+        case Command::Transfer: return "TRANSFER";
+        case Command::History:  return "HISTORY";
+        default:                return "?";
+    }
+}
+
+bool ScriptRunner::load(const std::string& scriptPath) {
+    std::ifstream script(scriptPath);
+    if (!script) {
+        std::cerr << "Cannot open script: " << scriptPath << std::endl;
+        return false;
+    }
+
+    steps.clear();
+    bool valid = true;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(script, line)) {
+        ++lineNumber;
+        if (!parseLine(line, lineNumber)) {
+            std::cerr << scriptPath << ":" << lineNumber << ": cannot parse '" << line << "'" << std::endl;
+            valid = false;
+        }
+    }
+
+    if (valid && steps.empty()) {
+        std::cerr << "Script has no commands: " << scriptPath << std::endl;
+        return false;
+    }
+    return valid;
+}
+
+bool ScriptRunner::parseLine(const std::string& line, int lineNumber) {
+    std::istringstream fields(line.substr(0, line.find('#')));
+    std::vector<std::string> words;
+    std::string word;
+    while (fields >> word) {
+        words.push_back(word);
+    }
+    if (words.empty()) {
+        return true;   // blank or comment-only
+    }
+
+    std::string verb = words[0];
+    std::transform(verb.begin(), verb.end(), verb.begin(), ::toupper);
+    size_t argumentCount = words.size() - 1;
+
+    Step step;
+    step.amount = Money();
+    step.pages = 1;
+    step.lineNumber = lineNumber;
+
+    if (verb == "LOGIN" && argumentCount == 2) {
+        step.command = Command::Login;
+        step.accountNumber = words[1];
+        step.pin = words[2];
+    } else if (verb == "LOGOUT" && argumentCount == 0) {
+        step.command = Command::Logout;
+    } else if (verb == "USE" && argumentCount == 1) {
+        step.command = Command::Use;
+        step.accountNumber = words[1];
+    } else if (verb == "BALANCE" && argumentCount == 0) {
+        step.command = Command::Balance;
+    } else if ((verb == "DEPOSIT" || verb == "WITHDRAW") && argumentCount == 1) {
+        step.command = (verb == "DEPOSIT") ? Command::Deposit : Command::Withdraw;
+        if (!Money::parse(words[1], step.amount)) {
+            return false;
+        }
+    } else if (verb == "TRANSFER" && argumentCount == 2) {
+        step.command = Command::Transfer;
+        step.accountNumber = words[1];
+        if (!Money::parse(words[2], step.amount)) {
+            return false;
+        }
+    } else if (verb == "HISTORY" && argumentCount <= 1) {
+        step.command = Command::History;
+        if (argumentCount == 1) {
+            step.pages = std::atoi(words[1].c_str());
+            if (step.pages < 1) {
+                return false;
+            }
+        }
+    } else {
+        return false;
+    }
+    if (!step.accountNumber.empty() && !bankingSystem.acceptsAccountNumber(step.accountNumber)) {
+        return false;
+    }
+
+    steps.push_back(step);
+    return true;
+}
+
+bool ScriptRunner::execute(const Step& step) {
+    Money newBalance;
+    switch (step.command) {
+        case Command::Login:
+            return bankingSystem.login(step.accountNumber, step.pin);
+        case Command::Logout:
+            bankingSystem.endSession();
+            return true;
+        case Command::Use:
+            return bankingSystem.useAccount(step.accountNumber);
+        case Command::Balance:
+            return !bankingSystem.currentBalance().isNegative();
+        case Command::Deposit:
+            return bankingSystem.depositAmount(step.amount, newBalance) == Database::TransactionResult::Success;
+        case Command::Withdraw:
+            return bankingSystem.withdrawAmount(step.amount, newBalance) == Database::TransactionResult::Success;
+        case Command::Transfer:
+            return bankingSystem.transferAmount(step.accountNumber, step.amount, newBalance)
+                   == Database::TransactionResult::Success;
+        case Command::History: {
+            // Newest page first, then keep paging back like a teller pressing [N]
+            Database::TransactionPage page = bankingSystem.historyPage(0, Database::PageDirection::Older);
+            for (int pageIndex = 1; page.loaded && pageIndex < step.pages && page.hasOlder; ++pageIndex) {
+                page = bankingSystem.historyPage(page.rows.back().transactionId, Database::PageDirection::Older);
+            }
+            return page.loaded;
+        }
+        default:
+            return false;
+    }
+}
+
+void ScriptRunner::run(long long repeat) {
+    auto started = std::chrono::steady_clock::now();
+
+    for (long long iteration = 0; iteration < repeat; ++iteration) {
+        for (const Step& step : steps) {
+            auto before = std::chrono::steady_clock::now();
+            bool ok = execute(step);
+            auto after = std::chrono::steady_clock::now();
+
+            CommandStats& commandStats = stats[static_cast<int>(step.command)];
+            ++commandStats.executed;
+            if (!ok) {
+                ++commandStats.failed;
+            }
+            commandStats.totalNs += std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count();
+        }
+    }
+
+    repetitions += repeat;
+    elapsedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void ScriptRunner::printReport(std::ostream& os) const {
+    long long totalOps = 0;
+    long long totalFailed = 0;
+
+    os << std::left << std::setw(12) << "Command"
+       << std::right << std::setw(12) << "Executed"
+       << std::setw(10) << "Failed"
+       << std::setw(14) << "Mean (us)" << std::endl;
+    os << std::string(48, '-') << std::endl;
+
+    for (int i = 0; i < static_cast<int>(Command::Count); ++i) {
+        const CommandStats& commandStats = stats[i];
+        if (commandStats.executed == 0) {
+            continue;
+        }
+        totalOps += commandStats.executed;
+        totalFailed += commandStats.failed;
+
+        os << std::left << std::setw(12) << commandName(static_cast<Command>(i))
+           << std::right << std::setw(12) << commandStats.executed
+           << std::setw(10) << commandStats.failed
+           << std::setw(14) << std::fixed << std::setprecision(1)
+           << commandStats.totalNs / 1000.0 / commandStats.executed << std::endl;
+    }
+
+    os << std::string(48, '-') << std::endl;
+    os << "Script runs: " << repetitions << std::endl;
+    os << "Operations: " << totalOps << " (" << totalFailed << " failed)" << std::endl;
+    os << "Elapsed: " << std::fixed << std::setprecision(3) << elapsedSeconds << " s" << std::endl;
+    os << "Throughput: " << std::setprecision(0) << totalOps / std::max(elapsedSeconds, 1e-9)
+       << " ops/s" << std::endl;
+}
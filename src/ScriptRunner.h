@@ -0,0 +1,67 @@
+#ifndef SCRIPT_RUNNER_H
+#define SCRIPT_RUNNER_H
+
+#include "BankingSystem.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Headless driver: replays a teller workload file against BankingSystem's
+// non-interactive core, with no terminal I/O, sleeps or child processes.
+//
+// One command per line, '#' starts a comment:
+//   LOGIN <account> <pin>     USE <account>      LOGOUT
+//   BALANCE                   DEPOSIT <amount>   WITHDRAW <amount>
+//   TRANSFER <account> <amount>                  HISTORY [pages]
+class ScriptRunner {
+private:
+    enum class Command {
+        Login,
+        Logout,
+        Use,
+        Balance,
+        Deposit,
+        Withdraw,
+        Transfer,
+        History,
+        Count
+    };
+
+    struct Step {
+        Command command;
+        std::string accountNumber;
+        std::string pin;
+        Money amount;
+        int pages;
+        int lineNumber;
+    };
+
+    struct CommandStats {
+        long long executed = 0;
+        long long failed = 0;
+        long long totalNs = 0;
+    };
+
+    BankingSystem& bankingSystem;
+    std::vector<Step> steps;
+    CommandStats stats[static_cast<int>(Command::Count)];
+    long long repetitions;
+    double elapsedSeconds;
+
+    static const char* commandName(Command command);
+    bool parseLine(const std::string& line, int lineNumber);
+    bool execute(const Step& step);
+
+public:
+    explicit ScriptRunner(BankingSystem& bankingSystem);
+
+    // Parse errors are reported with their line number; nothing runs if any line is bad
+    bool load(const std::string& scriptPath);
+
+    // Runs the whole script `repeat` times. Failed commands are counted, not fatal.
+    void run(long long repeat = 1);
+
+    void printReport(std::ostream& os) const;
+};
+
+#endif
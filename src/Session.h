@@ -0,0 +1,17 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <string>
+
+// Per-user state for one terminal, script or socket connection. Owned by the
+// caller and passed to BankingService explicitly, so one service can host
+// any number of concurrent sessions.
+struct Session {
+    int customerId = -1;
+    std::string accountNumber;      // the selected account, empty until one is chosen
+    bool isLoggedIn = false;
+    
+    bool hasAccount() const { return isLoggedIn && !accountNumber.empty(); }
+};
+
+#endif
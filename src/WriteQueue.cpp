@@ -0,0 +1,136 @@
+#include "WriteQueue.h"
+#include <algorithm>
+#include <iterator>
+#include <signal.h>
+
+WriteQueue::WriteQueue(Database& database, std::mutex& databaseMutex, size_t maxBatchOps,
+                       std::chrono::microseconds maxDelay)
+    : database(database), databaseMutex(databaseMutex), maxBatchOps(std::max(maxBatchOps, static_cast<size_t>(1))),
+      maxDelay(maxDelay), stopping(false), stats{0, 0, 0} {
+    // The flusher inherits a fully blocked mask, so process signals such as the
+    // server's SIGINT are only ever delivered to threads that expect them
+    sigset_t allSignals;
+    sigset_t previousMask;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_BLOCK, &allSignals, &previousMask);
+    flusher = std::thread(&WriteQueue::flushLoop, this);
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+}
+
+WriteQueue::~WriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_all();
+    flusher.join();
+}
+
+std::future<WriteQueue::Result> WriteQueue::submitTransaction(const std::string& accountNumber,
+                                                              TransactionType transactionType, Money amount,
+                                                              const std::string& description) {
+    Operation operation;
+    operation.isTransfer = false;
+    operation.accountNumber = accountNumber;
+    operation.transactionType = transactionType;
+    operation.amount = amount;
+    operation.description = description;
+    return enqueue(std::move(operation));
+}
+
+std::future<WriteQueue::Result> WriteQueue::submitTransfer(const std::string& fromAccount,
+                                                           const std::string& toAccount, Money amount,
+                                                           const std::string& description) {
+    Operation operation;
+    operation.isTransfer = true;
+    operation.accountNumber = fromAccount;
+    operation.transactionType = TransactionType::TransferOut;
+    operation.toAccount = toAccount;
+    operation.amount = amount;
+    operation.description = description;
+    return enqueue(std::move(operation));
+}
+
+WriteQueue::Stats WriteQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return stats;
+}
+
+std::future<WriteQueue::Result> WriteQueue::enqueue(Operation operation) {
+    std::future<Result> result = operation.promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) {
+            operation.promise.set_value(Result{Database::TransactionResult::DatabaseError, Money()});
+            return result;
+        }
+        operation.enqueuedAt = std::chrono::steady_clock::now();
+        pending.push_back(std::move(operation));
+    }
+    queueReady.notify_one();
+    return result;
+}
+
+void WriteQueue::flushLoop() {
+    std::vector<Operation> batch;
+    batch.reserve(maxBatchOps);
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueReady.wait(lock, [this]() { return stopping || !pending.empty(); });
+        if (pending.empty()) {
+            return;     // stopping, and everything submitted has been committed
+        }
+
+        // Give other sessions until the oldest operation's deadline to join this batch
+        std::chrono::steady_clock::time_point deadline = pending.front().enqueuedAt + maxDelay;
+        queueReady.wait_until(lock, deadline, [this]() { return stopping || pending.size() >= maxBatchOps; });
+
+        size_t count = std::min(pending.size(), maxBatchOps);
+        batch.assign(std::make_move_iterator(pending.begin()), std::make_move_iterator(pending.begin() + count));
+        pending.erase(pending.begin(), pending.begin() + count);
+
+        lock.unlock();
+        commitBatch(batch);
+        batch.clear();
+        lock.lock();
+    }
+}
+
+void WriteQueue::commitBatch(std::vector<Operation>& batch) {
+    std::vector<Result> results(batch.size(), Result{Database::TransactionResult::DatabaseError, Money()});
+    {
+        std::lock_guard<std::mutex> lock(databaseMutex);
+        if (database.beginTransaction()) {
+            // Nested calls run as savepoints inside the batch transaction
+            bool batchLost = false;
+            for (size_t i = 0; i < batch.size() && !batchLost; ++i) {
+                const Operation& operation = batch[i];
+                results[i].result = operation.isTransfer
+                    ? database.transferFunds(operation.accountNumber, operation.toAccount, operation.amount,
+                                             operation.description, results[i].balanceAfter)
+                    : database.applyTransaction(operation.accountNumber, operation.transactionType,
+                                                operation.amount, operation.description, results[i].balanceAfter);
+                // A hard SQLite error rolls back the whole transaction, earlier savepoints included
+                batchLost = !database.inTransaction();
+            }
+
+            if (batchLost || !database.commitTransaction()) {
+                database.rollbackTransaction();
+                std::fill(results.begin(), results.end(), Result{Database::TransactionResult::DatabaseError, Money()});
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        ++stats.batches;
+        stats.operations += batch.size();
+        stats.largestBatch = std::max(stats.largestBatch, batch.size());
+    }
+
+    // Only now is every write in the batch durable
+    for (size_t i = 0; i < batch.size(); ++i) {
+        batch[i].promise.set_value(results[i]);
+    }
+}
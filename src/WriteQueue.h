@@ -0,0 +1,83 @@
+#ifndef WRITE_QUEUE_H
+#define WRITE_QUEUE_H
+
+#include "Database.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Group commit for ledger writes. Any thread can submit deposits, withdrawals
+// and transfers. One flusher thread applies whatever is queued in a single
+// write transaction once maxBatchOps are waiting or the oldest has waited
+// maxDelay, and completes each caller's future only after COMMIT returns.
+// A batch therefore pays for one commit (and one fsync under the durable
+// profile) instead of one per operation.
+//
+// Each operation runs in its own savepoint, so a rejected one (insufficient
+// funds, unknown account) fails alone. If the batch cannot commit, every
+// operation in it reports DatabaseError.
+class WriteQueue {
+public:
+    struct Result {
+        Database::TransactionResult result;
+        Money balanceAfter;             // source account for transfers
+    };
+
+    struct Stats {
+        unsigned long long operations;
+        unsigned long long batches;
+        size_t largestBatch;
+    };
+
+    // databaseMutex is held while a batch runs, so other writers sharing the
+    // connection must take it too
+    WriteQueue(Database& database, std::mutex& databaseMutex, size_t maxBatchOps = 256,
+               std::chrono::microseconds maxDelay = std::chrono::microseconds(200));
+    ~WriteQueue();                      // commits everything still queued
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    std::future<Result> submitTransaction(const std::string& accountNumber, TransactionType transactionType,
+                                          Money amount, const std::string& description);
+    std::future<Result> submitTransfer(const std::string& fromAccount, const std::string& toAccount, Money amount,
+                                       const std::string& description);
+
+    Stats getStats() const;
+
+private:
+    struct Operation {
+        bool isTransfer;
+        std::string accountNumber;      // source for transfers
+        std::string toAccount;
+        TransactionType transactionType;
+        Money amount;
+        std::string description;
+        std::chrono::steady_clock::time_point enqueuedAt;
+        std::promise<Result> promise;
+    };
+
+    Database& database;
+    std::mutex& databaseMutex;
+    size_t maxBatchOps;
+    std::chrono::microseconds maxDelay;
+
+    mutable std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::deque<Operation> pending;
+    bool stopping;
+    Stats stats;
+
+    std::thread flusher;
+
+    std::future<Result> enqueue(Operation operation);
+    void flushLoop();
+    void commitBatch(std::vector<Operation>& batch);
+};
+
+#endif
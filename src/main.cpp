@@ -1,8 +1,19 @@
+#include "BankingServer.h"
 #include "BankingSystem.h"
 #include "Database.h"
+#include "FeeAssessment.h"
+#include "InterestAccrual.h"
+#include "LedgerReconciler.h"
+#include "ScriptRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
 #include <memory>
+#include <thread>
 
 // Function to display system information
 void displaySystemInfo() {
@@ -20,7 +31,272 @@ void displaySystemInfo() {
     std::cout << "\n Developed by Genevieve Osei-Owusu" << std::endl;
 }
 
-int main() {
+// Headless modes:
+//   banking_system.exe --script workload.txt [--repeat N] [--db PATH] [--profile NAME]
+//   banking_system.exe --server /tmp/atanga.sock|127.0.0.1:7070 [--workers N]
+//                      [--group-commit OPS] [--group-commit-us MICROS] [--db PATH] [--profile NAME]
+//   banking_system.exe --accrue-interest YYYY-MM --rate-bps N [--interest-days N] [--chunk N]
+//                      [--db PATH] [--profile NAME]
+//   banking_system.exe --assess-fees YYYY-MM [--threads N] [--chunk N] [--db PATH] [--profile NAME]
+//   banking_system.exe --reconcile MISMATCHES.tsv|- [--threads N] [--db PATH] [--profile NAME]
+struct CommandLineOptions {
+    std::string scriptPath;
+    std::string serverAddress;
+    std::string interestPeriod;
+    std::string feePeriod;
+    std::string reconcileOutput;
+    std::string dbPath = "bank_system.db";
+    std::string profileName;
+    long long repeat = 1;
+    int workers = 16;                       // a waiting write holds its worker, so this caps the batch size
+    long long groupCommitOps = 256;         // server only; 0 commits every write on its own
+    long long groupCommitMicros = 200;
+    int rateBasisPoints = 0;
+    int interestDays = 0;                   // 0 takes the days in the period's month
+    int threads = 0;                        // fee and reconcile threads; 0 takes one per hardware thread
+    int chunkSize = 0;                      // rows per commit for the batch jobs; 0 takes the job's default
+};
+
+bool parseCommandLine(int argc, char* argv[], CommandLineOptions& options) {
+    if (argc % 2 == 0) {
+        return false;
+    }
+    
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--script") {
+            options.scriptPath = argv[i + 1];
+        } else if (flag == "--server") {
+            options.serverAddress = argv[i + 1];
+        } else if (flag == "--repeat") {
+            options.repeat = std::atoll(argv[i + 1]);
+        } else if (flag == "--workers") {
+            options.workers = std::atoi(argv[i + 1]);
+        } else if (flag == "--group-commit") {
+            options.groupCommitOps = std::atoll(argv[i + 1]);
+        } else if (flag == "--group-commit-us") {
+            options.groupCommitMicros = std::atoll(argv[i + 1]);
+        } else if (flag == "--accrue-interest") {
+            options.interestPeriod = argv[i + 1];
+        } else if (flag == "--rate-bps") {
+            options.rateBasisPoints = std::atoi(argv[i + 1]);
+        } else if (flag == "--interest-days") {
+            options.interestDays = std::atoi(argv[i + 1]);
+        } else if (flag == "--assess-fees") {
+            options.feePeriod = argv[i + 1];
+        } else if (flag == "--reconcile") {
+            options.reconcileOutput = argv[i + 1];
+        } else if (flag == "--threads") {
+            options.threads = std::atoi(argv[i + 1]);
+        } else if (flag == "--chunk") {
+            options.chunkSize = std::atoi(argv[i + 1]);
+        } else if (flag == "--db") {
+            options.dbPath = argv[i + 1];
+        } else if (flag == "--profile") {
+            options.profileName = argv[i + 1];
+        } else {
+            return false;
+        }
+    }
+    
+    // Exactly one mode
+    int modes = !options.scriptPath.empty() + !options.serverAddress.empty() + !options.interestPeriod.empty() +
+                !options.feePeriod.empty() + !options.reconcileOutput.empty();
+    return modes == 1 && options.repeat >= 1 && options.workers >= 1 && options.threads >= 0 &&
+           options.groupCommitOps >= 0 && options.groupCommitMicros >= 0;
+}
+
+void printAccountCacheStats(const Database::AccountCacheStats& stats) {
+    unsigned long long lookups = stats.hits + stats.misses;
+    if (lookups == 0) {
+        return;
+    }
+    std::cout << "Account cache: " << stats.hits << " of " << lookups << " lookups served from memory ("
+              << std::fixed << std::setprecision(1) << 100.0 * stats.hits / lookups << "% hit rate)" << std::endl;
+}
+
+int runScript(const CommandLineOptions& options) {
+    BankingSystem bankingSystem(options.dbPath, options.profileName);
+    if (!bankingSystem.initialize()) {
+        return 1;
+    }
+    
+    ScriptRunner runner(bankingSystem);
+    if (!runner.load(options.scriptPath)) {
+        return 1;
+    }
+    runner.run(options.repeat);
+    runner.printReport(std::cout);
+    printAccountCacheStats(bankingSystem.getAccountCacheStats());
+    return 0;
+}
+
+int runServer(const CommandLineOptions& options) {
+    auto service = std::make_shared<BankingService>(options.dbPath, options.profileName);
+    if (!service->initialize()) {
+        std::cerr << "Failed to connect to database!" << std::endl;
+        return 1;
+    }
+    
+    service->enableGroupCommit(static_cast<size_t>(options.groupCommitOps),
+                               std::chrono::microseconds(options.groupCommitMicros));
+    
+    BankingServer server(service, options.workers);
+    if (!server.listenOn(options.serverAddress)) {
+        return 1;
+    }
+    std::cout << "ATANGA Banking Server listening on " << options.serverAddress << std::endl;
+    server.run();
+    
+    WriteQueue::Stats stats;
+    if (service->getGroupCommitStats(stats) && stats.batches > 0) {
+        std::cout << "Group commit: " << stats.operations << " writes in " << stats.batches << " commits (largest "
+                  << stats.largestBatch << ")" << std::endl;
+    }
+    
+    AccountLockManager::Stats lockStats = service->getAccountLockStats();
+    if (lockStats.contended > 0) {
+        std::cout << "Account locks: " << lockStats.contended << " of " << lockStats.acquisitions
+                  << " acquisitions waited, " << lockStats.waitNs / 1000000 << " ms in total" << std::endl;
+        for (const AccountLockManager::HotAccount& hot : service->getHotAccounts(5)) {
+            std::cout << "  " << hot.accountNumber << "  " << hot.contended << " waits" << std::endl;
+        }
+    }
+    
+    printAccountCacheStats(service->getAccountCacheStats());
+    return 0;
+}
+
+int runInterestAccrual(const CommandLineOptions& options) {
+    Database database(options.dbPath, options.profileName);
+    if (!database.connect()) {
+        std::cerr << "Failed to connect to database!" << std::endl;
+        return 1;
+    }
+    
+    InterestAccrual::Options accrualOptions = {options.interestPeriod, options.rateBasisPoints,
+                                               options.interestDays, options.chunkSize};
+    InterestAccrual::Report report;
+    if (!InterestAccrual(database).run(accrualOptions, report)) {
+        return 1;
+    }
+    
+    if (report.alreadyCompleted) {
+        std::cout << "Interest for " << options.interestPeriod << " was already posted: ";
+    } else {
+        std::cout << "Interest for " << options.interestPeriod << (report.resumed ? " (resumed): " : ": ");
+    }
+    std::cout << report.totalInterest << " to " << report.accountsCredited << " accounts";
+    if (!report.alreadyCompleted) {
+        std::cout << " in " << std::fixed << std::setprecision(2) << report.seconds << " s ("
+                  << report.chunksCommitted << " commits)";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+
+int runFeeAssessment(const CommandLineOptions& options) {
+    // One reader per scan thread
+    Database database(options.dbPath, options.profileName);
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    database.setReaderPoolSize(std::max(1, threads));
+    if (!database.connect()) {
+        std::cerr << "Failed to connect to database!" << std::endl;
+        return 1;
+    }
+    
+    FeeAssessment::Options feeOptions = {options.feePeriod, threads, options.chunkSize};
+    FeeAssessment::Report report;
+    if (!FeeAssessment(database).run(feeOptions, report)) {
+        return 1;
+    }
+    
+    if (report.alreadyCompleted) {
+        std::cout << "Fees for " << options.feePeriod << " were already assessed: ";
+    } else {
+        std::cout << "Fees for " << options.feePeriod << (report.resumed ? " (resumed): " : ": ");
+    }
+    std::cout << report.feesCharged << " fees totalling " << report.totalFees << ", " << report.feesUncollected
+              << " uncollected" << std::endl;
+    if (!report.alreadyCompleted) {
+        std::cout << "Scanned " << report.accountsScanned << " accounts in " << report.partitions << " ranges on "
+                  << report.threads << " threads (" << std::fixed << std::setprecision(2) << report.scanSeconds
+                  << " s), posted in " << report.batchesCommitted << " commits (" << report.postSeconds << " s)"
+                  << std::endl;
+    }
+    return 0;
+}
+
+// Exits 2 when the ledger does not reconcile, so maintenance scripts can tell it from a failed run
+int runReconciliation(const CommandLineOptions& options) {
+    std::ofstream file;
+    if (options.reconcileOutput != "-") {
+        file.open(options.reconcileOutput);
+        if (!file) {
+            std::cerr << "Cannot write " << options.reconcileOutput << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+    
+    // One reader per worker
+    Database database(options.dbPath, options.profileName);
+    int threads = options.threads > 0 ? options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    database.setReaderPoolSize(std::max(1, threads));
+    if (!database.connect()) {
+        std::cerr << "Failed to connect to database!" << std::endl;
+        return 1;
+    }
+    
+    LedgerReconciler::Options reconcileOptions = {threads, LedgerReconciler::DEFAULT_MAX_REPORTED};
+    LedgerReconciler::Report report;
+    if (!LedgerReconciler(database).run(reconcileOptions, report)) {
+        return 1;
+    }
+    
+    out << "account_number\tcheck\ttransaction_id\texpected\tactual\n";
+    for (const LedgerReconciler::Mismatch& mismatch : report.reported) {
+        out << mismatch.accountNumber << '\t' << LedgerReconciler::checkName(mismatch.check) << '\t'
+            << mismatch.transactionId << '\t' << mismatch.expected << '\t' << mismatch.actual << '\n';
+    }
+    out.flush();
+    
+    std::cerr << "Reconciled " << report.accounts << " accounts and " << report.ledgerRows << " ledger rows in "
+              << std::fixed << std::setprecision(2) << report.seconds << " s ("
+              << std::setprecision(0) << report.ledgerRows / std::max(report.seconds, 1e-9) << " rows/s) on "
+              << report.threads << " threads, " << report.ranges << " ranges, " << report.steals << " stolen: "
+              << report.mismatches << " mismatches";
+    if (report.mismatches > static_cast<long long>(report.reported.size())) {
+        std::cerr << " (first " << report.reported.size() << " listed)";
+    }
+    std::cerr << std::endl;
+    return report.mismatches > 0 ? 2 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        CommandLineOptions options;
+        if (!parseCommandLine(argc, argv, options)) {
+            std::cerr << "Usage: " << argv[0] << " [--script FILE [--repeat N] | --server ADDRESS [--workers N]"
+                      << " [--group-commit OPS] [--group-commit-us MICROS]"
+                      << " | --accrue-interest YYYY-MM --rate-bps N [--interest-days N] [--chunk N]"
+                      << " | --assess-fees YYYY-MM [--threads N] [--chunk N]"
+                      << " | --reconcile FILE|- [--threads N]]"
+                      << " [--db PATH] [--profile NAME]" << std::endl;
+            return 1;
+        }
+        if (!options.interestPeriod.empty()) {
+            return runInterestAccrual(options);
+        }
+        if (!options.feePeriod.empty()) {
+            return runFeeAssessment(options);
+        }
+        if (!options.reconcileOutput.empty()) {
+            return runReconciliation(options);
+        }
+        return options.scriptPath.empty() ? runServer(options) : runScript(options);
+    }
+    
     try {
         // Display system information
         displaySystemInfo();
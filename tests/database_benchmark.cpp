@@ -0,0 +1,466 @@
+#include "Database.h"
+#include "WriteQueue.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Latency benchmark for the hot Database calls, run against a dataset made by
+// test_data_generator.exe (see `make bench`). Prints one JSON document so
+// results from two builds can be diffed or loaded side by side.
+
+struct BenchmarkOptions {
+    std::string dbPath = "bench.db";
+    std::string profile;                    // empty: ATANGA_DB_PROFILE or durable
+    std::string only;                       // comma-separated case names, empty runs all
+    std::string outputPath;                 // JSON to stdout when empty
+    unsigned long long seed = 42;
+    long long readIterations = 100000;
+    long long writeIterations = 2000;
+    int readerThreads = 4;
+    int writerThreads = 16;
+    long long groupCommitOps = 256;
+    long long groupCommitMicros = 200;
+    long long accountCacheCapacity = 4096;  // 0 sends every balance lookup to SQLite
+};
+
+// Transfers per transferFundsBatch() call in the transfer_batch case
+const long long TRANSFER_BATCH_SIZE = 100;
+
+struct BenchmarkResult {
+    std::string name;
+    long long iterations = 0;
+    long long errors = 0;
+    double seconds = 0.0;
+    std::vector<int64_t> latenciesNs;
+};
+
+struct SampleAccount {
+    std::string accountNumber;
+    int customerId;
+};
+
+class DatabaseBenchmark {
+private:
+    BenchmarkOptions options;
+    Database database;
+    std::mt19937_64 gen;
+    std::vector<SampleAccount> accounts;
+    std::vector<BenchmarkResult> results;
+
+    const SampleAccount& pickAccount() {
+        std::uniform_int_distribution<size_t> dis(0, accounts.size() - 1);
+        return accounts[dis(gen)];
+    }
+
+    bool selected(const std::string& name) const {
+        if (options.only.empty()) {
+            return true;
+        }
+        std::string list = "," + options.only + ",";
+        return list.find("," + name + ",") != std::string::npos;
+    }
+
+    // Every call is timed on its own; the first 1% warms the page and statement caches
+    void run(const std::string& name, long long iterations, const std::function<bool()>& operation) {
+        if (!selected(name)) {
+            return;
+        }
+
+        long long warmup = std::max(iterations / 100, 1LL);
+        for (long long i = 0; i < warmup; ++i) {
+            operation();
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.latenciesNs.reserve(iterations);
+
+        std::cerr << "⏱️  " << name << " x " << iterations << "..." << std::endl;
+        auto started = std::chrono::steady_clock::now();
+        for (long long i = 0; i < iterations; ++i) {
+            auto before = std::chrono::steady_clock::now();
+            if (!operation()) {
+                ++result.errors;
+            }
+            auto after = std::chrono::steady_clock::now();
+            result.latenciesNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        results.push_back(std::move(result));
+    }
+
+    // Splits the iterations over threadCount threads, each with its own
+    // account sampler, to measure how calls scale with concurrent sessions
+    void runConcurrent(const std::string& name, long long iterations, int threadCount,
+                       const std::function<bool(const std::string&)>& operation) {
+        if (!selected(name)) {
+            return;
+        }
+
+        std::vector<std::vector<int64_t>> latencies(threadCount);
+        std::vector<long long> errors(threadCount, 0);
+
+        std::cerr << "⏱️  " << name << " x " << iterations << " on " << threadCount << " threads..." << std::endl;
+        auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937_64 threadGen(options.seed + t + 1);
+                std::uniform_int_distribution<size_t> dis(0, accounts.size() - 1);
+                long long share = iterations / threadCount + (t < iterations % threadCount ? 1 : 0);
+                latencies[t].reserve(share);
+                for (long long i = 0; i < share; ++i) {
+                    auto before = std::chrono::steady_clock::now();
+                    if (!operation(accounts[dis(threadGen)].accountNumber)) {
+                        ++errors[t];
+                    }
+                    auto after = std::chrono::steady_clock::now();
+                    latencies[t].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        for (int t = 0; t < threadCount; ++t) {
+            result.errors += errors[t];
+            result.latenciesNs.insert(result.latenciesNs.end(), latencies[t].begin(), latencies[t].end());
+        }
+        results.push_back(std::move(result));
+    }
+
+public:
+    explicit DatabaseBenchmark(const BenchmarkOptions& opts)
+        : options(opts), database(opts.dbPath, opts.profile), gen(opts.seed) {
+        database.setAccountCacheCapacity(static_cast<size_t>(opts.accountCacheCapacity));
+    }
+
+    // Read the account sample straight from the file so the benchmark does
+    // not depend on which ids the generator happened to assign
+    bool loadSample() {
+        sqlite3* handle = nullptr;
+        if (sqlite3_open_v2(options.dbPath.c_str(), &handle, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            std::cerr << "❌ Cannot open " << options.dbPath << ": " << sqlite3_errmsg(handle) << std::endl;
+            sqlite3_close(handle);
+            return false;
+        }
+
+        const char* sql = R"(
+            SELECT account_number, customer_id FROM accounts
+            WHERE status = ?
+            ORDER BY account_number;
+        )";
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(handle, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_int(stmt, 1, static_cast<int>(AccountStatus::Active));
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                accounts.push_back({reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)),
+                                    sqlite3_column_int(stmt, 1)});
+            }
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_close(handle);
+
+        if (accounts.empty()) {
+            std::cerr << "❌ No active accounts in " << options.dbPath
+                      << "; generate a dataset with test_data_generator.exe first" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool initialize() {
+        // Connect first so an older file is migrated before the sample query reads it
+        return database.connect() && loadSample();
+    }
+
+    void runAll() {
+        const Money smallAmount = Money::fromMajorUnits(1);
+
+        // Same two lookups BankingSystem::login makes
+        run("login", options.readIterations, [&]() {
+            const SampleAccount& account = pickAccount();
+            int customerId = database.getCustomerIdByAccountNumber(account.accountNumber);
+            return customerId != -1 && database.validateCustomerLogin(customerId, "1234");
+        });
+
+        run("balance", options.readIterations, [&]() {
+            return !database.getAccountBalance(pickAccount().accountNumber).isNegative();
+        });
+
+        run("history_page", options.readIterations, [&]() {
+            Database::TransactionPage page = database.getTransactionPage(pickAccount().accountNumber, 0, 10,
+                                                                         Database::PageDirection::Older);
+            return !page.rows.empty();
+        });
+
+        runConcurrent("balance_concurrent", options.readIterations, options.readerThreads, [&](const std::string& accountNumber) {
+            return !database.getAccountBalance(accountNumber).isNegative();
+        });
+
+        runConcurrent("history_page_concurrent", options.readIterations, options.readerThreads, [&](const std::string& accountNumber) {
+            return !database.getTransactionPage(accountNumber, 0, 10, Database::PageDirection::Older).rows.empty();
+        });
+
+        // Deposits and withdrawals of the same amount keep the dataset's balances stable
+        run("deposit", options.writeIterations, [&]() {
+            Money balanceAfter;
+            return database.applyTransaction(pickAccount().accountNumber, TransactionType::Deposit, smallAmount,
+                                             "Benchmark deposit", balanceAfter)
+                   == Database::TransactionResult::Success;
+        });
+
+        run("withdraw", options.writeIterations, [&]() {
+            Money balanceAfter;
+            Database::TransactionResult result = database.applyTransaction(
+                pickAccount().accountNumber, TransactionType::Withdrawal, smallAmount, "Benchmark withdrawal", balanceAfter);
+            // An empty account is a valid outcome, not a benchmark failure
+            return result == Database::TransactionResult::Success ||
+                   result == Database::TransactionResult::InsufficientFunds;
+        });
+
+        run("transfer", options.writeIterations, [&]() {
+            Money fromBalanceAfter;
+            Database::TransactionResult result = database.transferFunds(
+                pickAccount().accountNumber, pickAccount().accountNumber, smallAmount, "", fromBalanceAfter);
+            return result == Database::TransactionResult::Success ||
+                   result == Database::TransactionResult::InsufficientFunds ||
+                   result == Database::TransactionResult::SameAccount;
+        });
+
+        // One sample is a whole batch committed at once
+        run("transfer_batch", std::max(options.writeIterations / TRANSFER_BATCH_SIZE, 1LL), [&]() {
+            std::vector<Database::TransferRequest> transfers;
+            transfers.reserve(TRANSFER_BATCH_SIZE);
+            for (long long i = 0; i < TRANSFER_BATCH_SIZE; ++i) {
+                transfers.push_back({pickAccount().accountNumber, pickAccount().accountNumber, smallAmount, ""});
+            }
+            for (const Database::TransferReceipt& receipt : database.transferFundsBatch(transfers)) {
+                if (receipt.result == Database::TransactionResult::DatabaseError) {
+                    return false;
+                }
+            }
+            return true;
+        });
+
+        // Many sessions depositing at once: first one commit per deposit, as the
+        // service does without group commit, then batched through a WriteQueue
+        std::mutex writerMutex;
+        runConcurrent("deposit_concurrent", options.writeIterations, options.writerThreads,
+                      [&](const std::string& accountNumber) {
+            std::lock_guard<std::mutex> lock(writerMutex);
+            Money balanceAfter;
+            return database.applyTransaction(accountNumber, TransactionType::Deposit, smallAmount, "Benchmark deposit", balanceAfter)
+                   == Database::TransactionResult::Success;
+        });
+
+        if (selected("deposit_grouped")) {
+            WriteQueue writeQueue(database, writerMutex, static_cast<size_t>(options.groupCommitOps),
+                                  std::chrono::microseconds(options.groupCommitMicros));
+            runConcurrent("deposit_grouped", options.writeIterations, options.writerThreads,
+                          [&](const std::string& accountNumber) {
+                return writeQueue.submitTransaction(accountNumber, TransactionType::Deposit, smallAmount, "Benchmark deposit")
+                           .get().result == Database::TransactionResult::Success;
+            });
+            WriteQueue::Stats stats = writeQueue.getStats();
+            std::cerr << "   " << stats.operations << " deposits in " << stats.batches << " commits (largest "
+                      << stats.largestBatch << ")" << std::endl;
+        }
+
+        run("create_account", options.writeIterations, [&]() {
+            return database.createAccount(pickAccount().customerId, AccountType::Savings, Money::fromMajorUnits(100));
+        });
+    }
+
+    static double percentileUs(const std::vector<int64_t>& sorted, double percentile) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        // Nearest-rank, so p999 of 1000 samples is the slowest call
+        size_t rank = static_cast<size_t>(percentile / 100.0 * sorted.size() + 0.999999);
+        rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted.size());
+        return sorted[rank - 1] / 1000.0;
+    }
+
+    std::string toJson() {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3);
+        json << "{\n"
+             << "  \"database\": \"" << options.dbPath << "\",\n"
+             << "  \"profile\": \"" << database.getStorageProfile().name << "\",\n"
+             << "  \"seed\": " << options.seed << ",\n"
+             << "  \"sample_accounts\": " << accounts.size() << ",\n"
+             << "  \"reader_pool\": " << (database.hasReaderPool() ? "true" : "false") << ",\n"
+             << "  \"reader_threads\": " << options.readerThreads << ",\n"
+             << "  \"writer_threads\": " << options.writerThreads << ",\n"
+             << "  \"group_commit\": {\"max_ops\": " << options.groupCommitOps
+             << ", \"max_delay_us\": " << options.groupCommitMicros << "},\n"
+             << "  \"benchmarks\": [";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            BenchmarkResult& result = results[i];
+            std::sort(result.latenciesNs.begin(), result.latenciesNs.end());
+
+            int64_t totalNs = 0;
+            for (int64_t latency : result.latenciesNs) {
+                totalNs += latency;
+            }
+            double meanUs = result.latenciesNs.empty() ? 0.0 : totalNs / 1000.0 / result.latenciesNs.size();
+
+            json << (i == 0 ? "\n" : ",\n")
+                 << "    {\"name\": \"" << result.name << "\""
+                 << ", \"iterations\": " << result.iterations
+                 << ", \"errors\": " << result.errors
+                 << ", \"ops_per_sec\": " << result.iterations / std::max(result.seconds, 1e-9)
+                 << ", \"mean_us\": " << meanUs
+                 << ", \"p50_us\": " << percentileUs(result.latenciesNs, 50.0)
+                 << ", \"p99_us\": " << percentileUs(result.latenciesNs, 99.0)
+                 << ", \"p999_us\": " << percentileUs(result.latenciesNs, 99.9)
+                 << ", \"max_us\": " << (result.latenciesNs.empty() ? 0.0 : result.latenciesNs.back() / 1000.0)
+                 << "}";
+        }
+
+        Database::StatementCacheStats cache = database.getStatementCacheStats();
+        json << "\n  ],\n"
+             << "  \"statement_cache\": {\"hits\": " << cache.hits
+             << ", \"misses\": " << cache.misses
+             << ", \"cached_statements\": " << cache.cachedStatements << "},\n";
+        
+        Database::AccountCacheStats accountCache = database.getAccountCacheStats();
+        json << "  \"account_cache\": {\"capacity\": " << options.accountCacheCapacity
+             << ", \"hits\": " << accountCache.hits
+             << ", \"misses\": " << accountCache.misses
+             << ", \"cached_accounts\": " << accountCache.cachedAccounts
+             << ", \"cached_customers\": " << accountCache.cachedCustomers << "}\n"
+             << "}\n";
+        return json.str();
+    }
+};
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --db PATH                dataset to run against (default bench.db)\n"
+                  << "  --profile NAME           durable | balanced | bulk-load (default: ATANGA_DB_PROFILE or durable)\n"
+                  << "  --only LIST              comma-separated cases: login,balance,history_page,\n"
+                  << "                           balance_concurrent,history_page_concurrent,\n"
+                  << "                           deposit,withdraw,transfer,transfer_batch,\n"
+                  << "                           deposit_concurrent,deposit_grouped,create_account\n"
+                  << "  --read-iterations N      calls per read case (default 100000)\n"
+                  << "  --write-iterations N     calls per write case (default 2000)\n"
+                  << "  --reader-threads N       threads for the *_concurrent read cases (default 4)\n"
+                  << "  --writer-threads N       threads for deposit_concurrent and deposit_grouped (default 16)\n"
+                  << "  --group-commit N         most deposits per deposit_grouped commit (default 256)\n"
+                  << "  --group-commit-us N      longest a deposit waits for its batch to fill (default 200)\n"
+                  << "  --account-cache N        cached accounts and customers, 0 disables (default 4096)\n"
+                  << "  --seed N                 account sampling seed (default 42)\n"
+                  << "  --output PATH            write the JSON here instead of stdout\n";
+    }
+
+    bool parseCount(const char* text, long long minimum, long long& value) {
+        char* end = nullptr;
+        long long parsed = std::strtoll(text, &end, 10);
+        if (end == text || *end != '\0' || parsed < minimum) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h" || i + 1 >= argc) {
+                return false;
+            }
+
+            const char* value = argv[++i];
+            long long number = 0;
+            Database::StorageProfile profile;
+            bool ok = true;
+            if (flag == "--db") {
+                options.dbPath = value;
+            } else if (flag == "--profile") {
+                options.profile = value;
+                ok = Database::findStorageProfile(options.profile, profile);
+            } else if (flag == "--only") {
+                options.only = value;
+            } else if (flag == "--read-iterations") {
+                ok = parseCount(value, 1, options.readIterations);
+            } else if (flag == "--write-iterations") {
+                ok = parseCount(value, 1, options.writeIterations);
+            } else if (flag == "--reader-threads") {
+                ok = parseCount(value, 1, number);
+                options.readerThreads = static_cast<int>(number);
+            } else if (flag == "--writer-threads") {
+                ok = parseCount(value, 1, number);
+                options.writerThreads = static_cast<int>(number);
+            } else if (flag == "--group-commit") {
+                ok = parseCount(value, 1, options.groupCommitOps);
+            } else if (flag == "--group-commit-us") {
+                ok = parseCount(value, 0, options.groupCommitMicros);
+            } else if (flag == "--account-cache") {
+                ok = parseCount(value, 0, options.accountCacheCapacity);
+            } else if (flag == "--seed") {
+                ok = parseCount(value, 0, number);
+                options.seed = static_cast<unsigned long long>(number);
+            } else if (flag == "--output") {
+                options.outputPath = value;
+            } else {
+                ok = false;
+            }
+
+            if (!ok) {
+                std::cerr << "❌ Invalid value for " << flag << ": " << value << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    DatabaseBenchmark benchmark(options);
+    if (!benchmark.initialize()) {
+        return 1;
+    }
+    benchmark.runAll();
+
+    std::string json = benchmark.toJson();
+    if (options.outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(options.outputPath);
+        if (!out) {
+            std::cerr << "❌ Cannot write " << options.outputPath << std::endl;
+            return 1;
+        }
+        out << json;
+        std::cerr << "📄 Results written to " << options.outputPath << std::endl;
+    }
+    return 0;
+}
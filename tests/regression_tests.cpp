@@ -0,0 +1,402 @@
+#include "Database.h"
+#include "FeeAssessment.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Behavioural checks for the Database layer and the batch jobs built on it.
+// Every check starts from an empty file, so they run in any order; the exit
+// status is the number of checks that failed.
+//
+//   bin/regression_tests.exe [--db PATH] [--only LIST]
+
+// Fails the enclosing check, naming the condition and its line
+#define EXPECT(condition)                                                                   \
+    if (!(condition)) {                                                                     \
+        std::cerr << "   line " << __LINE__ << ": expected " << #condition << std::endl;    \
+        return false;                                                                       \
+    }
+
+struct TestOptions {
+    std::string dbPath = "regression.db";
+    std::string only;                   // comma-separated check names; empty runs them all
+};
+
+class RegressionTests {
+private:
+    TestOptions options;
+    int checksRun = 0;
+    int checksFailed = 0;
+    int customersOpened = 0;
+
+    bool selected(const std::string& name) const {
+        if (options.only.empty()) {
+            return true;
+        }
+        std::string list = "," + options.only + ",";
+        return list.find("," + name + ",") != std::string::npos;
+    }
+
+    void removeDatabaseFiles() const {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::remove((options.dbPath + suffix).c_str());
+        }
+    }
+
+    // Connected to an empty file; an empty pointer if it could not connect
+    std::unique_ptr<Database> freshDatabase() {
+        removeDatabaseFiles();
+        std::unique_ptr<Database> database(new Database(options.dbPath, "durable"));
+        if (!database->connect()) {
+            return nullptr;
+        }
+        return database;
+    }
+
+    // One customer (PIN 1234) holding an account of the given type per
+    // balance, returned in account-number order
+    std::vector<std::string> openAccounts(Database& database, AccountType accountType,
+                                          const std::vector<Money>& balances) {
+        std::vector<std::string> accountNumbers;
+        int customerId = 0;
+        if (!database.insertCustomer("Ama", "", "Mensah", "ama" + std::to_string(++customersOpened) + "@example.com",
+                                     "0240000000", "Accra", "1990-01-01", "1234", &customerId)) {
+            return accountNumbers;
+        }
+        for (Money balance : balances) {
+            std::string accountNumber;
+            if (!database.createAccount(customerId, accountType, balance, &accountNumber)) {
+                return {};
+            }
+            accountNumbers.push_back(accountNumber);
+        }
+        return accountNumbers;
+    }
+
+    void check(const std::string& name, const std::function<bool()>& body) {
+        if (!selected(name)) {
+            return;
+        }
+        ++checksRun;
+        if (body()) {
+            std::cerr << "✅ " << name << std::endl;
+        } else {
+            ++checksFailed;
+            std::cerr << "❌ " << name << std::endl;
+        }
+        removeDatabaseFiles();
+    }
+
+public:
+    explicit RegressionTests(const TestOptions& opts) : options(opts) {}
+
+    void runAll() {
+        // Paging walks the whole ledger once, and a cursor from another
+        // account or an unknown id reports no page on either side
+        check("history_cursor", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings, {Money(), Money()});
+            EXPECT(accounts.size() == 2);
+            Money balanceAfter;
+            for (int i = 0; i < 5; ++i) {
+                EXPECT(database->applyTransaction(accounts[0], TransactionType::Deposit, Money::fromMajorUnits(1),
+                                                  "Deposit", balanceAfter) == Database::TransactionResult::Success);
+            }
+            EXPECT(database->applyTransaction(accounts[1], TransactionType::Deposit, Money::fromMajorUnits(1),
+                                              "Deposit", balanceAfter) == Database::TransactionResult::Success);
+            const size_t ledgerRows = database->getTransactionHistory(accounts[0], 100).size();
+
+            Database::TransactionPage page = database->getTransactionPage(accounts[0], 0, 2,
+                                                                          Database::PageDirection::Older);
+            EXPECT(page.loaded && page.rows.size() == 2 && page.hasOlder && !page.hasNewer);
+            std::vector<long long> seen;
+            while (true) {
+                for (const Database::TransactionRow& row : page.rows) {
+                    EXPECT(seen.empty() || row.transactionId < seen.back());
+                    seen.push_back(row.transactionId);
+                }
+                if (!page.hasOlder) {
+                    break;
+                }
+                page = database->getTransactionPage(accounts[0], seen.back(), 2, Database::PageDirection::Older);
+                EXPECT(page.loaded && page.hasNewer);
+            }
+            EXPECT(seen.size() == ledgerRows);
+
+            // The oldest row is a real cursor with nothing beyond it
+            page = database->getTransactionPage(accounts[0], seen.back(), 2, Database::PageDirection::Older);
+            EXPECT(page.loaded && page.rows.empty() && !page.hasOlder && page.hasNewer);
+            page = database->getTransactionPage(accounts[0], seen.back(), 2, Database::PageDirection::Newer);
+            EXPECT(page.loaded && page.rows.size() == 2 && page.hasOlder && page.hasNewer);
+            EXPECT(page.rows[0].transactionId == seen[seen.size() - 3] &&
+                   page.rows[1].transactionId == seen[seen.size() - 2]);
+
+            const long long foreignCursor =
+                database->getTransactionPage(accounts[1], 0, 1, Database::PageDirection::Older).rows.at(0).transactionId;
+            for (long long cursor : {foreignCursor, seen.front() + 1000}) {
+                for (Database::PageDirection direction : {Database::PageDirection::Older,
+                                                          Database::PageDirection::Newer}) {
+                    page = database->getTransactionPage(accounts[0], cursor, 2, direction);
+                    EXPECT(page.loaded && page.rows.empty() && !page.hasOlder && !page.hasNewer);
+                }
+            }
+            return true;
+        });
+
+        // Every single-digit slip and adjacent swap fails the check digit,
+        // until the v4 migration finds a pre-sequence number in the file
+        check("luhn", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings, {Money(), Money()});
+            EXPECT(accounts.size() == 2);
+            const std::string& number = accounts[0];
+            EXPECT(Database::isValidAccountNumber(number) && database->acceptsAccountNumber(number));
+            for (size_t i = 0; i < number.size(); ++i) {
+                std::string mistyped = number;
+                mistyped[i] = static_cast<char>('0' + (mistyped[i] - '0' + 1) % 10);
+                EXPECT(!Database::isValidAccountNumber(mistyped) && !database->acceptsAccountNumber(mistyped));
+                // Luhn's one blind spot is swapping a 0 and a 9
+                if (i + 1 < number.size() && number[i] != number[i + 1] && number[i] + number[i + 1] != '0' + '9') {
+                    std::string swapped = number;
+                    std::swap(swapped[i], swapped[i + 1]);
+                    EXPECT(!database->acceptsAccountNumber(swapped));
+                }
+            }
+            for (const std::string& malformed : {std::string(""), number.substr(1), number + "0",
+                                                 number.substr(0, 4) + "x" + number.substr(5)}) {
+                EXPECT(!database->acceptsAccountNumber(malformed));
+            }
+
+            // Renumber the second account as a legacy file would hold it and
+            // make the migration look again
+            std::string legacy = accounts[1];
+            legacy[legacy.size() - 1] = static_cast<char>('0' + (legacy.back() - '0' + 1) % 10);
+            database.reset();
+            sqlite3* handle = nullptr;
+            EXPECT(sqlite3_open(options.dbPath.c_str(), &handle) == SQLITE_OK);
+            const std::string sql = "UPDATE accounts SET account_number = '" + legacy + "' WHERE account_number = '" +
+                                    accounts[1] + "'; PRAGMA user_version = 3;";
+            const bool renumbered = sqlite3_exec(handle, sql.c_str(), 0, 0, 0) == SQLITE_OK;
+            sqlite3_close(handle);
+            EXPECT(renumbered);
+
+            database.reset(new Database(options.dbPath, "durable"));
+            EXPECT(database->connect());
+            EXPECT(database->acceptsAccountNumber(legacy) && database->accountExists(legacy));
+            EXPECT(!database->acceptsAccountNumber(number.substr(1)));
+            return true;
+        });
+
+        // An empty history is a loaded page; a read that fails is not
+        check("history_loaded", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings, {Money()});
+            EXPECT(accounts.size() == 1);
+            Database::TransactionPage page = database->getTransactionPage(accounts[0], 0, 10,
+                                                                          Database::PageDirection::Older);
+            EXPECT(page.loaded && page.rows.empty());
+
+            // Take the ledger away underneath the prepared history statements
+            sqlite3* handle = nullptr;
+            EXPECT(sqlite3_open(options.dbPath.c_str(), &handle) == SQLITE_OK);
+            const bool moved = sqlite3_exec(handle, "ALTER TABLE transactions RENAME TO transactions_moved",
+                                            0, 0, 0) == SQLITE_OK;
+            sqlite3_close(handle);
+            EXPECT(moved);
+
+            page = database->getTransactionPage(accounts[0], 0, 10, Database::PageDirection::Older);
+            EXPECT(!page.loaded && page.rows.empty());
+            return true;
+        });
+
+        // Each entry gets its own outcome, and only the accepted ones post
+        check("ledger_batch_results", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings,
+                                                             {Money::fromMajorUnits(10), Money::fromMajorUnits(1)});
+            EXPECT(accounts.size() == 2);
+            const std::string unknown = "99999999" + std::string(1, Database::luhnCheckDigit("99999999"));
+            const size_t ledgerRows = database->getTransactionHistory(accounts[1], 100).size();
+
+            std::vector<Database::TransactionResult> results;
+            EXPECT(!database->postLedgerBatch(TransactionType::Fee, {accounts[0]}, {100}, "Fee", results));
+            EXPECT(database->beginTransaction());
+            EXPECT(database->postLedgerBatch(TransactionType::Fee, {accounts[0], accounts[1], unknown, accounts[0]},
+                                             {500, 500, 100, 0}, "Fee", results));
+            EXPECT(database->commitTransaction());
+
+            EXPECT(results.size() == 4);
+            EXPECT(results[0] == Database::TransactionResult::Success);
+            EXPECT(results[1] == Database::TransactionResult::InsufficientFunds);
+            EXPECT(results[2] == Database::TransactionResult::AccountNotFound);
+            EXPECT(results[3] == Database::TransactionResult::InvalidAmount);
+            EXPECT(database->getAccountBalance(accounts[0]) == Money::fromMajorUnits(5));
+            EXPECT(database->getAccountBalance(accounts[1]) == Money::fromMajorUnits(1));
+            EXPECT(database->getTransactionHistory(accounts[1], 100).size() == ledgerRows);
+            return true;
+        });
+
+        // The limit stops the withdrawal that would cross it, and a ledger
+        // batch cannot withdraw around it
+        check("daily_withdrawal_limit", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            database->setDailyWithdrawalLimit(Money::fromMajorUnits(100));
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings,
+                                                             {Money::fromMajorUnits(500)});
+            EXPECT(accounts.size() == 1);
+
+            Money balanceAfter;
+            EXPECT(database->applyTransaction(accounts[0], TransactionType::Withdrawal, Money::fromMajorUnits(60),
+                                              "Withdrawal", balanceAfter) == Database::TransactionResult::Success);
+            EXPECT(database->applyTransaction(accounts[0], TransactionType::Withdrawal, Money::fromMajorUnits(50),
+                                              "Withdrawal", balanceAfter) ==
+                   Database::TransactionResult::DailyLimitExceeded);
+            EXPECT(database->getDailyWithdrawalTotal(accounts[0]) == Money::fromMajorUnits(60));
+
+            std::vector<Database::TransactionResult> results;
+            EXPECT(database->beginTransaction());
+            EXPECT(!database->postLedgerBatch(TransactionType::Withdrawal, {accounts[0]}, {5000}, "Withdrawal",
+                                              results));
+            EXPECT(database->rollbackTransaction());
+            EXPECT(database->getAccountBalance(accounts[0]) == Money::fromMajorUnits(440));
+            EXPECT(database->getDailyWithdrawalTotal(accounts[0]) == Money::fromMajorUnits(60));
+            return true;
+        });
+
+        // A full cache evicts the entry read longest ago
+        check("account_cache_lru", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            database->setAccountCacheCapacity(2);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings,
+                                                             {Money::fromMajorUnits(1), Money::fromMajorUnits(2),
+                                                              Money::fromMajorUnits(3)});
+            EXPECT(accounts.size() == 3);
+
+            const Database::AccountCacheStats before = database->getAccountCacheStats();
+            for (int i : {0, 1, 0, 2, 0, 1}) {     // the read of 2 evicts 1, which then misses again
+                EXPECT(database->getAccountBalance(accounts[i]) == Money::fromMajorUnits(i + 1));
+            }
+            const Database::AccountCacheStats after = database->getAccountCacheStats();
+            EXPECT(after.hits - before.hits == 2 && after.misses - before.misses == 4);
+            EXPECT(after.cachedAccounts == 2);
+            return true;
+        });
+
+        // Another connection's commit reaches this one's cached balance
+        // within the data_version poll interval
+        check("account_cache_external_commit", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings,
+                                                             {Money::fromMajorUnits(10)});
+            EXPECT(accounts.size() == 1);
+            EXPECT(database->getAccountBalance(accounts[0]) == Money::fromMajorUnits(10));
+
+            Database other(options.dbPath, "durable");
+            EXPECT(other.connect());
+            Money balanceAfter;
+            EXPECT(other.applyTransaction(accounts[0], TransactionType::Deposit, Money::fromMajorUnits(5), "Deposit",
+                                          balanceAfter) == Database::TransactionResult::Success);
+            std::this_thread::sleep_for(std::chrono::milliseconds(250));
+            EXPECT(database->getAccountBalance(accounts[0]) == Money::fromMajorUnits(15));
+
+            // This connection's own writes land in the cache at once
+            EXPECT(database->applyTransaction(accounts[0], TransactionType::Deposit, Money::fromMajorUnits(5),
+                                              "Deposit", balanceAfter) == Database::TransactionResult::Success);
+            EXPECT(database->getAccountBalance(accounts[0]) == Money::fromMajorUnits(20));
+            return true;
+        });
+
+        // A run interrupted after its second account charges only the
+        // accounts after that checkpoint, and a finished run charges nothing
+        check("fee_resume", [&]() {
+            std::unique_ptr<Database> database = freshDatabase();
+            EXPECT(database);
+            // Four Savings accounts under the seeded 100.00 minimum balance, each owing 5.00
+            std::vector<std::string> accounts = openAccounts(*database, AccountType::Savings,
+                                                             std::vector<Money>(4, Money::fromMajorUnits(50)));
+            EXPECT(accounts.size() == 4);
+            EXPECT(database->splitAccountRange(2) == std::vector<std::string>({"", accounts[2]}));
+
+            Database::FeeRun interrupted = {"2026-09", accounts[1], 2, Money::fromMajorUnits(10), 0, false};
+            EXPECT(database->saveFeeRun(interrupted));
+
+            FeeAssessment::Options feeOptions = {"2026-09", 2, 1};
+            FeeAssessment::Report report;
+            EXPECT(FeeAssessment(*database).run(feeOptions, report));
+            EXPECT(report.resumed && !report.alreadyCompleted);
+            EXPECT(report.feesCharged == 4 && report.totalFees == Money::fromMajorUnits(20));
+            for (size_t i = 0; i < accounts.size(); ++i) {
+                EXPECT(database->getAccountBalance(accounts[i]) == Money::fromMajorUnits(i < 2 ? 50 : 45));
+            }
+
+            EXPECT(FeeAssessment(*database).run(feeOptions, report));
+            EXPECT(report.alreadyCompleted);
+            Database::FeeRun finished;
+            EXPECT(database->loadFeeRun("2026-09", finished));
+            EXPECT(finished.completed && finished.feesCharged == 4);
+            EXPECT(database->getAccountBalance(accounts[3]) == Money::fromMajorUnits(45));
+            return true;
+        });
+    }
+
+    int failed() const {
+        return checksFailed;
+    }
+
+    int run() const {
+        return checksRun;
+    }
+};
+
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --db PATH                scratch file, deleted after every check (default regression.db)\n"
+                  << "  --only LIST              comma-separated check names\n";
+    }
+
+    bool parseArguments(int argc, char* argv[], TestOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h" || i + 1 >= argc) {
+                return false;
+            }
+
+            const char* value = argv[++i];
+            if (flag == "--db") {
+                options.dbPath = value;
+            } else if (flag == "--only") {
+                options.only = value;
+            } else {
+                std::cerr << "❌ Unknown option " << flag << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    TestOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    RegressionTests tests(options);
+    tests.runAll();
+    std::cerr << tests.run() - tests.failed() << " of " << tests.run() << " checks passed" << std::endl;
+    return tests.failed();
+}
@@ -3,13 +3,51 @@
 #include <vector>
 #include <random>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+
+// Non-interactive synthetic dataset loader. Every row goes through the
+// Database's cached prepared statements inside large explicit transactions,
+// so a 10M-transaction ledger loads in minutes under the bulk-load profile.
+//
+//   bin/test_data_generator.exe --db bench.db --customers 100000 --accounts 200000
+//                               --transactions 10000000 --distribution zipf
+
+struct GeneratorOptions {
+    std::string dbPath = "bank_system.db";
+    unsigned long long seed = 42;
+    long long customers = 10;
+    long long accounts = 15;
+    long long transactions = 75;
+    std::string distribution = "uniform";   // uniform | zipf
+    double zipfExponent = 1.0;
+    long long batchSize = 50000;            // rows per commit
+    int historyDays = 365;                  // ledger dates span this many days back from now
+};
 
 class TestDataGenerator {
 private:
+    GeneratorOptions options;
     std::unique_ptr<Database> database;
-    std::random_device rd;
-    std::mt19937 gen;
-    
+    std::mt19937_64 gen;
+
+    // In-memory view of what has been loaded; balances are flushed per batch
+    std::vector<std::string> accountNumbers;
+    std::vector<AccountType> accountTypes;
+    std::vector<Money> balances;
+    std::vector<char> dirty;
+    std::vector<size_t> dirtyAccounts;
+
+    // Zipfian activity: cumulative weights by rank, and rank -> account index
+    std::vector<double> zipfCumulative;
+    std::vector<size_t> zipfAccountByRank;
+
+    long long rowsInBatch = 0;
+    long long rowsWritten = 0;
+
     // Sample data arrays
     std::vector<std::string> firstNames = {
         "Kwame", "Akua", "Kofi", "Ama", "Yaw", "Efua", "Kwaku", "Abena",
@@ -17,254 +55,404 @@ private:
         "Maame", "Nana", "Adjoa", "Kojo", "Esi", "Emmanuel", "Grace",
         "Samuel", "Diana", "Michael", "Sarah", "David", "Rebecca"
     };
-    
+
     std::vector<std::string> lastNames = {
         "Asante", "Osei", "Mensah", "Amoah", "Boateng", "Owusu", "Danso",
         "Antwi", "Gyasi", "Nkrumah", "Appiah", "Darko", "Badu", "Frimpong",
         "Opoku", "Yeboah", "Acheampong", "Bonsu", "Marfo", "Wiredu"
     };
-    
+
     std::vector<std::string> cities = {
         "Kumasi", "Accra", "Takoradi", "Tamale", "Cape Coast", "Sunyani",
         "Ho", "Koforidua", "Wa", "Bolgatanga", "Techiman", "Obuasi"
     };
-    
+
     std::vector<std::string> areas = {
         "North Campus", "South Campus", "Unity Hall", "University Hall",
         "Independence Hall", "Republic Hall", "New Hall", "Africa Hall",
         "Ahinsan", "Ayeduase", "Bomso", "Kentinkrono", "Maxima"
     };
 
+    std::vector<std::string> domains = {"@gmail.com", "@yahoo.com", "@knust.edu.gh", "@outlook.com"};
+
+    template <typename T>
+    const T& pick(const std::vector<T>& values) {
+        std::uniform_int_distribution<size_t> dis(0, values.size() - 1);
+        return values[dis(gen)];
+    }
+
 public:
-    TestDataGenerator() : gen(rd()) {
-        database = std::make_unique<Database>();
+    explicit TestDataGenerator(const GeneratorOptions& opts) : options(opts), gen(opts.seed) {
+        database = std::make_unique<Database>(options.dbPath, "bulk-load");
     }
-    
+
     bool initialize() {
         return database->connect();
     }
-    
-    std::string generateRandomEmail(const std::string& firstName, const std::string& lastName) {
-        std::vector<std::string> domains = {"@gmail.com", "@yahoo.com", "@knust.edu.gh", "@outlook.com"};
-        std::uniform_int_distribution<> domainDis(0, domains.size() - 1);
-        
-        std::string email = firstName + "." + lastName + domains[domainDis(gen)];
+
+    // Email carries the customer ordinal so it stays unique at any scale
+    std::string generateEmail(const std::string& firstName, const std::string& lastName, long long ordinal) {
+        std::string email = firstName + "." + lastName + "." + std::to_string(ordinal) + pick(domains);
         std::transform(email.begin(), email.end(), email.begin(), ::tolower);
         return email;
     }
-    
+
     std::string generateRandomPhone() {
         std::uniform_int_distribution<> dis(20000000, 59999999);
         return "0" + std::to_string(dis(gen));
     }
-    
+
     std::string generateRandomAddress() {
-        std::uniform_int_distribution<> cityDis(0, cities.size() - 1);
-        std::uniform_int_distribution<> areaDis(0, areas.size() - 1);
         std::uniform_int_distribution<> houseDis(1, 999);
-        
-        return cities[cityDis(gen)] + ", " + areas[areaDis(gen)] + 
-               ", House " + std::to_string(houseDis(gen));
+        return pick(cities) + ", " + pick(areas) + ", House " + std::to_string(houseDis(gen));
     }
-    
+
     std::string generateRandomDOB() {
         std::uniform_int_distribution<> dayDis(1, 28);
         std::uniform_int_distribution<> monthDis(1, 12);
         std::uniform_int_distribution<> yearDis(1990, 2005);
-        
-        return std::to_string(dayDis(gen)) + "/" + 
-               std::to_string(monthDis(gen)) + "/" + 
+
+        return std::to_string(dayDis(gen)) + "/" +
+               std::to_string(monthDis(gen)) + "/" +
                std::to_string(yearDis(gen));
     }
-    
-    std::string generateRandomPIN() {
-        std::uniform_int_distribution<> dis(1000, 9999);
-        return std::to_string(dis(gen));
+
+    Money generateRandomBalance() {
+        std::uniform_int_distribution<int64_t> dis(Money::fromMajorUnits(100).getMinorUnits(),
+                                                   Money::fromMajorUnits(50000).getMinorUnits());
+        return Money::fromMinorUnits(dis(gen));
     }
-    
-    double generateRandomBalance() {
-        std::uniform_real_distribution<> dis(100.0, 50000.0);
-        return std::round(dis(gen) * 100.0) / 100.0; // Round to 2 decimal places
+
+    static std::string formatTimestamp(std::time_t seconds) {
+        std::tm utc{};
+        gmtime_r(&seconds, &utc);
+        char buffer[20];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc);
+        return buffer;
     }
-    
-    void generateTestCustomers(int count = 10) {
-        std::cout << "🧪 Generating " << count << " test customers..." << std::endl;
-        
-        std::uniform_int_distribution<> firstNameDis(0, firstNames.size() - 1);
-        std::uniform_int_distribution<> lastNameDis(0, lastNames.size() - 1);
-        
-        for (int i = 0; i < count; ++i) {
-            std::string firstName = firstNames[firstNameDis(gen)];
-            std::string lastName = lastNames[lastNameDis(gen)];
-            std::string middleName = (i % 3 == 0) ? firstNames[firstNameDis(gen)] : "";
-            
-            std::string email = generateRandomEmail(firstName, lastName);
-            std::string phone = generateRandomPhone();
-            std::string address = generateRandomAddress();
-            std::string dob = generateRandomDOB();
-            std::string pin = generateRandomPIN();
-            
-            if (database->insertCustomer(firstName, middleName, lastName, email, phone, address, dob, pin)) {
-                std::cout << "✅ Created customer: " << firstName << " " << lastName 
-                         << " (PIN: " << pin << ")" << std::endl;
-            } else {
-                std::cout << "❌ Failed to create customer: " << firstName << " " << lastName << std::endl;
+
+    // Batch bookkeeping
+    void markDirty(size_t accountIndex) {
+        if (!dirty[accountIndex]) {
+            dirty[accountIndex] = 1;
+            dirtyAccounts.push_back(accountIndex);
+        }
+    }
+
+    bool flushBalances() {
+        for (size_t accountIndex : dirtyAccounts) {
+            if (!database->updateAccountBalance(accountNumbers[accountIndex], balances[accountIndex])) {
+                return false;
             }
+            dirty[accountIndex] = 0;
+        }
+        dirtyAccounts.clear();
+        return true;
+    }
+
+    // Every committed batch leaves accounts.balance consistent with the ledger
+    bool commitBatch() {
+        if (!flushBalances() || !database->commitTransaction()) {
+            database->rollbackTransaction();
+            return false;
+        }
+        rowsInBatch = 0;
+        return true;
+    }
+
+    bool rowWritten() {
+        ++rowsWritten;
+        if (++rowsInBatch < options.batchSize) {
+            return true;
         }
+        return commitBatch() && database->beginTransaction();
     }
-    
-    void generateTestAccountsForCustomers() {
-        std::cout << "\n🏦 Creating bank accounts for customers..." << std::endl;
-        
-        // This is a simplified approach - in a real system you'd query for customer IDs
-        std::uniform_int_distribution<> accountTypeDis(0, 1);
-        std::vector<std::string> accountTypes = {"Savings", "Checkings"};
-        
-        for (int customerId = 1; customerId <= 10; ++customerId) {
-            // Create 1-2 accounts per customer
-            int numAccounts = (customerId % 3 == 0) ? 2 : 1;
-            
-            for (int j = 0; j < numAccounts; ++j) {
-                std::string accountType = accountTypes[accountTypeDis(gen)];
-                double initialBalance = generateRandomBalance();
-                
-                if (database->createAccount(customerId, accountType, initialBalance)) {
-                    std::cout << "✅ Created " << accountType << " account for customer " 
-                             << customerId << " with balance: $" << std::fixed 
-                             << std::setprecision(2) << initialBalance << std::endl;
-                }
+
+    // Activity distribution
+    void buildZipfTable() {
+        size_t count = accountNumbers.size();
+        zipfCumulative.resize(count);
+        double total = 0.0;
+        for (size_t rank = 0; rank < count; ++rank) {
+            total += 1.0 / std::pow(static_cast<double>(rank + 1), options.zipfExponent);
+            zipfCumulative[rank] = total;
+        }
+
+        // Hot accounts are spread over the number range, not just the first ones opened
+        zipfAccountByRank.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            zipfAccountByRank[i] = i;
+        }
+        std::shuffle(zipfAccountByRank.begin(), zipfAccountByRank.end(), gen);
+    }
+
+    size_t pickAccount() {
+        if (zipfCumulative.empty()) {
+            std::uniform_int_distribution<size_t> dis(0, accountNumbers.size() - 1);
+            return dis(gen);
+        }
+        std::uniform_real_distribution<double> dis(0.0, zipfCumulative.back());
+        auto it = std::upper_bound(zipfCumulative.begin(), zipfCumulative.end(), dis(gen));
+        size_t rank = std::min(static_cast<size_t>(it - zipfCumulative.begin()), zipfCumulative.size() - 1);
+        return zipfAccountByRank[rank];
+    }
+
+    // Generation phases
+    bool generateCustomers(std::vector<int>& customerIds) {
+        std::cout << "👥 Generating " << options.customers << " customers..." << std::endl;
+        customerIds.reserve(options.customers);
+
+        for (long long i = 0; i < options.customers; ++i) {
+            std::string firstName = pick(firstNames);
+            std::string lastName = pick(lastNames);
+            std::string middleName = (i % 3 == 0) ? pick(firstNames) : "";
+
+            int customerId = -1;
+            if (!database->insertCustomer(firstName, middleName, lastName, generateEmail(firstName, lastName, i + 1),
+                                          generateRandomPhone(), generateRandomAddress(), generateRandomDOB(),
+                                          "1234", &customerId)) {
+                std::cerr << "❌ Failed to create customer " << (i + 1) << std::endl;
+                return false;
+            }
+            customerIds.push_back(customerId);
+
+            if (!rowWritten()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool generateAccounts(const std::vector<int>& customerIds, const std::string& openingDate) {
+        std::cout << "🏦 Generating " << options.accounts << " accounts..." << std::endl;
+        accountNumbers.reserve(options.accounts);
+        accountTypes.reserve(options.accounts);
+        balances.reserve(options.accounts);
+        dirty.reserve(options.accounts);
+
+        for (long long i = 0; i < options.accounts; ++i) {
+            // Every customer gets one account before anyone gets a second
+            int customerId = customerIds[i % customerIds.size()];
+            AccountType accountType = (gen() & 1) ? AccountType::Savings : AccountType::Checkings;
+            Money openingBalance = generateRandomBalance();
+
+            // Opened empty; the backdated opening deposit below keeps the ledger in date order
+            std::string accountNumber;
+            if (!database->createAccount(customerId, accountType, Money(), &accountNumber) ||
+                !database->recordTransaction(accountNumber, TransactionType::Deposit, openingBalance,
+                                             openingBalance, "Initial deposit", openingDate)) {
+                std::cerr << "❌ Failed to create account for customer " << customerId << std::endl;
+                return false;
+            }
+
+            accountNumbers.push_back(accountNumber);
+            accountTypes.push_back(accountType);
+            balances.push_back(openingBalance);
+            dirty.push_back(0);
+            markDirty(accountNumbers.size() - 1);
+
+            if (!rowWritten() || !rowWritten()) {
+                return false;
             }
         }
+        return true;
     }
-    
-    void generateTestTransactions() {
-        std::cout << "\n💳 Generating test transactions..." << std::endl;
-        
-        // Get all accounts and generate some transactions
-        std::uniform_real_distribution<> amountDis(10.0, 1000.0);
-        std::uniform_int_distribution<> typeDis(0, 1);
-        std::vector<std::string> transactionTypes = {"DEPOSIT", "WITHDRAWAL"};
-        
-        for (int customerId = 1; customerId <= 10; ++customerId) {
-            std::vector<std::string> accounts = database->getCustomerAccounts(customerId);
-            
-            for (const auto& accountInfo : accounts) {
-                size_t pos = accountInfo.find('|');
-                std::string accountNumber = accountInfo.substr(0, pos);
-                double currentBalance = database->getAccountBalance(accountNumber);
-                
-                // Generate 3-7 transactions per account
-                std::uniform_int_distribution<> transCountDis(3, 7);
-                int numTransactions = transCountDis(gen);
-                
-                for (int k = 0; k < numTransactions; ++k) {
-                    std::string transactionType = transactionTypes[typeDis(gen)];
-                    double amount = std::round(amountDis(gen) * 100.0) / 100.0;
-                    
-                    if (transactionType == "WITHDRAWAL" && amount > currentBalance) {
-                        // Convert to deposit if insufficient funds
-                        transactionType = "DEPOSIT";
-                    }
-                    
-                    double newBalance = (transactionType == "DEPOSIT") ? 
-                                      currentBalance + amount : currentBalance - amount;
-                    
-                    if (newBalance >= 0) {
-                        database->updateAccountBalance(accountNumber, newBalance);
-                        database->recordTransaction(accountNumber, transactionType, amount, newBalance, 
-                                                  "Test " + transactionType.substr(0, 1) + 
-                                                  transactionType.substr(1));
-                        currentBalance = newBalance;
-                    }
-                }
-                
-                std::cout << "✅ Generated transactions for account: " << accountNumber << std::endl;
+
+    bool generateTransactions(std::time_t firstSecond, std::time_t lastSecond) {
+        std::cout << "💳 Generating " << options.transactions << " transactions ("
+                  << options.distribution << " activity)..." << std::endl;
+        if (options.distribution == "zipf") {
+            buildZipfTable();
+        }
+
+        std::uniform_int_distribution<int64_t> amountDis(Money::fromMajorUnits(10).getMinorUnits(),
+                                                         Money::fromMajorUnits(1000).getMinorUnits());
+        const std::string depositDescription = "Test deposit";
+        const std::string withdrawalDescription = "Test withdrawal";
+
+        double secondsPerTransaction = static_cast<double>(lastSecond - firstSecond) /
+                                       static_cast<double>(options.transactions);
+        std::time_t formattedSecond = -1;
+        std::string transactionDate;
+
+        auto started = std::chrono::steady_clock::now();
+        long long reportEvery = std::max(options.transactions / 10, 1LL);
+
+        for (long long i = 0; i < options.transactions; ++i) {
+            // Dates rise with transaction_id, like a live ledger
+            std::time_t second = firstSecond + static_cast<std::time_t>(i * secondsPerTransaction);
+            if (second != formattedSecond) {
+                transactionDate = formatTimestamp(second);
+                formattedSecond = second;
+            }
+
+            size_t accountIndex = pickAccount();
+            Money amount = Money::fromMinorUnits(amountDis(gen));
+            // Convert to deposit if insufficient funds
+            bool isDeposit = (gen() & 1) || amount > balances[accountIndex];
+
+            if (isDeposit) {
+                balances[accountIndex] += amount;
+            } else {
+                balances[accountIndex] -= amount;
+            }
+
+            TransactionType type = isDeposit ? TransactionType::Deposit : TransactionType::Withdrawal;
+            if (!database->recordTransaction(accountNumbers[accountIndex], type, amount, balances[accountIndex],
+                                             isDeposit ? depositDescription : withdrawalDescription,
+                                             transactionDate)) {
+                std::cerr << "❌ Failed to record transaction " << (i + 1) << std::endl;
+                return false;
+            }
+            markDirty(accountIndex);
+
+            if (!rowWritten()) {
+                return false;
+            }
+
+            if ((i + 1) % reportEvery == 0) {
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+                std::cout << "   " << std::setw(12) << (i + 1) << " / " << options.transactions
+                          << "  (" << std::fixed << std::setprecision(0) << (i + 1) / std::max(elapsed, 1e-9)
+                          << " rows/s)" << std::endl;
             }
         }
+        return true;
     }
-    
-    void displayTestAccounts() {
-        std::cout << "\n📋 TEST ACCOUNTS SUMMARY" << std::endl;
-        std::cout << std::string(80, '=') << std::endl;
-        std::cout << std::left << std::setw(15) << "Customer ID" 
-                  << std::setw(12) << "Account#" 
+
+    void displaySampleAccounts(size_t count = 5) {
+        std::cout << "\n📋 SAMPLE ACCOUNTS (PIN: 1234)" << std::endl;
+        std::cout << std::string(50, '=') << std::endl;
+        std::cout << std::left << std::setw(15) << "Account#"
                   << std::setw(12) << "Type"
-                  << std::setw(12) << "Balance"
-                  << "PIN" << std::endl;
-        std::cout << std::string(80, '-') << std::endl;
-        
-        for (int customerId = 1; customerId <= 10; ++customerId) {
-            Database::CustomerInfo customer = database->getCustomerInfo(customerId);
-            if (customer.customerId != -1) {
-                std::vector<std::string> accounts = database->getCustomerAccounts(customerId);
-                
-                for (const auto& accountInfo : accounts) {
-                    size_t pos1 = accountInfo.find('|');
-                    size_t pos2 = accountInfo.find('|', pos1 + 1);
-                    
-                    std::string accountNumber = accountInfo.substr(0, pos1);
-                    std::string accountType = accountInfo.substr(pos1 + 1, pos2 - pos1 - 1);
-                    std::string balance = accountInfo.substr(pos2 + 1);
-                    
-                    std::cout << std::left << std::setw(15) << customerId
-                              << std::setw(12) << accountNumber
-                              << std::setw(12) << accountType
-                              << "$" << std::setw(11) << std::fixed << std::setprecision(2) << std::stod(balance)
-                              << "****" << std::endl; // Don't show actual PINs
-                }
-            }
+                  << "Balance" << std::endl;
+        std::cout << std::string(50, '-') << std::endl;
+
+        for (size_t i = 0; i < std::min(count, accountNumbers.size()); ++i) {
+            std::cout << std::left << std::setw(15) << accountNumbers[i]
+                      << std::setw(12) << AccountCodes::name(accountTypes[i])
+                      << "$" << balances[i] << std::endl;
         }
-        
-        std::cout << std::string(80, '=') << std::endl;
-        std::cout << "\n💡 Use any account number above with PIN '1234' for testing" << std::endl;
-        std::cout << "   (All test accounts have been set with PIN: 1234)" << std::endl;
+        std::cout << std::string(50, '=') << std::endl;
     }
-    
-    void generateCompleteTestData() {
+
+    bool generateCompleteTestData() {
         if (!initialize()) {
             std::cerr << "❌ Failed to initialize database!" << std::endl;
-            return;
+            return false;
+        }
+
+        std::cout << "🚀 Loading into " << options.dbPath << " (seed " << options.seed
+                  << ", " << options.batchSize << " rows per commit)\n" << std::endl;
+
+        auto started = std::chrono::steady_clock::now();
+        std::time_t lastSecond = std::time(nullptr);
+        std::time_t firstSecond = lastSecond - static_cast<std::time_t>(options.historyDays) * 86400;
+
+        if (!database->beginTransaction()) {
+            return false;
         }
-        
-        std::cout << "🚀 Generating complete test dataset for KNUST Banking System...\n" << std::endl;
-        
-        generateTestCustomers(10);
-        generateTestAccountsForCustomers();
-        generateTestTransactions();
-        
-        std::cout << "\n✅ Test data generation complete!" << std::endl;
-        displayTestAccounts();
-        
-        std::cout << "\n🎯 Quick Test Instructions:" << std::endl;
-        std::cout << "1. Run the banking system: ./banking_system" << std::endl;
-        std::cout << "2. Choose 'Login to Existing Account'" << std::endl;
-        std::cout << "3. Use any account number from the table above" << std::endl;
-        std::cout << "4. Use PIN: 1234 (for all test accounts)" << std::endl;
-        std::cout << "5. Explore all banking features!" << std::endl;
+
+        std::vector<int> customerIds;
+        if (!generateCustomers(customerIds) ||
+            !generateAccounts(customerIds, formatTimestamp(firstSecond)) ||
+            !generateTransactions(firstSecond, lastSecond) ||
+            !commitBatch()) {
+            database->rollbackTransaction();
+            std::cerr << "❌ Generation stopped; the last committed batch is kept." << std::endl;
+            return false;
+        }
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        std::cout << "\n✅ Wrote " << rowsWritten << " rows in " << std::fixed << std::setprecision(1)
+                  << elapsed << "s (" << std::setprecision(0) << rowsWritten / std::max(elapsed, 1e-9)
+                  << " rows/s)" << std::endl;
+
+        displaySampleAccounts();
+        return true;
     }
 };
 
-int main() {
-    TestDataGenerator generator;
-    
+namespace {
+    void printUsage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --db PATH              database file (default bank_system.db)\n"
+                  << "  --seed N               random seed (default 42)\n"
+                  << "  --customers N          customers to create (default 10)\n"
+                  << "  --accounts N           accounts, spread round-robin over customers (default 15)\n"
+                  << "  --transactions N       ledger rows after the opening deposits (default 75)\n"
+                  << "  --distribution NAME    uniform | zipf account activity (default uniform)\n"
+                  << "  --zipf-exponent X      skew for zipf (default 1.0)\n"
+                  << "  --batch-size N         rows per commit (default 50000)\n"
+                  << "  --days N               ledger history span in days (default 365)\n";
+    }
+
+    bool parseCount(const char* text, long long minimum, long long& value) {
+        char* end = nullptr;
+        long long parsed = std::strtoll(text, &end, 10);
+        if (end == text || *end != '\0' || parsed < minimum) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    bool parseArguments(int argc, char* argv[], GeneratorOptions& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--help" || flag == "-h" || i + 1 >= argc) {
+                return false;
+            }
+
+            const char* value = argv[++i];
+            long long number = 0;
+            bool ok = true;
+            if (flag == "--db") {
+                options.dbPath = value;
+            } else if (flag == "--seed") {
+                ok = parseCount(value, 0, number);
+                options.seed = static_cast<unsigned long long>(number);
+            } else if (flag == "--customers") {
+                ok = parseCount(value, 1, options.customers);
+            } else if (flag == "--accounts") {
+                ok = parseCount(value, 1, options.accounts);
+            } else if (flag == "--transactions") {
+                ok = parseCount(value, 0, options.transactions);
+            } else if (flag == "--distribution") {
+                options.distribution = value;
+                ok = options.distribution == "uniform" || options.distribution == "zipf";
+            } else if (flag == "--zipf-exponent") {
+                char* end = nullptr;
+                options.zipfExponent = std::strtod(value, &end);
+                ok = end != value && *end == '\0' && options.zipfExponent > 0.0;
+            } else if (flag == "--batch-size") {
+                ok = parseCount(value, 1, options.batchSize);
+            } else if (flag == "--days") {
+                ok = parseCount(value, 1, number);
+                options.historyDays = static_cast<int>(number);
+            } else {
+                ok = false;
+            }
+
+            if (!ok) {
+                std::cerr << "❌ Invalid value for " << flag << ": " << value << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
     std::cout << "🏦 KNUST Banking System - Test Data Generator" << std::endl;
     std::cout << std::string(50, '=') << std::endl;
-    
-    char choice;
-    std::cout << "\nThis will create sample customers, accounts, and transactions." << std::endl;
-    std::cout << "⚠️  Warning: This will modify the database!" << std::endl;
-    std::cout << "\nProceed? (y/n): ";
-    std::cin >> choice;
-    
-    if (choice == 'y' || choice == 'Y') {
-        generator.generateCompleteTestData();
-    } else {
-        std::cout << "❌ Operation cancelled." << std::endl;
-    }
-    
-    std::cout << "\nPress Enter to exit...";
-    std::cin.ignore();
-    std::cin.get();
-    
-    return 0;
-}
\ No newline at end of file
+
+    TestDataGenerator generator(options);
+    return generator.generateCompleteTestData() ? 0 : 1;
+}